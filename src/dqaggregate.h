@@ -0,0 +1,52 @@
+#ifndef DQAGGREGATE_H
+#define DQAGGREGATE_H
+
+#include <QString>
+
+/// An aggregate function applied on a field
+/**
+  It is used by DQSharedQuery::aggregate() to retrieve several aggregate results
+  of each group in a single query.
+
+\code
+    DQColumnSet stats = DQQuery<ExamResult>().groupBy("subject")
+                        .aggregate(QList<DQAggregate>() << DQAggregate("count","id")
+                                                        << DQAggregate("avg","mark")
+                                                        << DQAggregate("max","mark"));
+    // Columns : "subject" , "count(id)" , "avg(mark)" , "max(mark)"
+\endcode
+
+  @see DQSharedQuery::aggregate()
+ */
+
+class DQAggregate {
+public:
+    /// Construct an aggregate
+    /**
+      @param func The SQL aggregate function. e.g count , sum , avg , min , max , total
+      @param field The field passed to the function. "*" could be used with count.
+     */
+    DQAggregate(QString func , QString field) : m_func(func) , m_field(field) {
+    }
+
+    /// The function name
+    QString func() const {
+        return m_func;
+    }
+
+    /// The field passed to the function
+    QString field() const {
+        return m_field;
+    }
+
+    /// The result column in SQL. e.g "count(id)"
+    QString toString() const {
+        return QString("%1(%2)").arg(m_func).arg(m_field);
+    }
+
+private:
+    QString m_func;
+    QString m_field;
+};
+
+#endif // DQAGGREGATE_H
@@ -0,0 +1,95 @@
+#include <QtCore>
+#include <QSqlError>
+#include "dqasync.h"
+#include "dqasync_p.h"
+
+/// No. of created worker. It is used to name the cloned database.
+static QAtomicInt m_workerCount;
+
+DQAsyncTask::~DQAsyncTask(){
+}
+
+DQAsyncWorker::DQAsyncWorker(QSqlDatabase database , QList<DQModelMetaInfo*> models) :
+    m_database(database),
+    m_models(models),
+    m_stopping(false)
+{
+}
+
+DQAsyncWorker::~DQAsyncWorker(){
+    stop();
+}
+
+void DQAsyncWorker::enqueue(DQAsyncTask *task){
+    m_mutex.lock();
+
+    if (m_stopping) {
+        m_mutex.unlock();
+        task->discard();
+        delete task;
+        return;
+    }
+
+    m_queue.enqueue(task);
+    m_condition.wakeOne();
+    m_mutex.unlock();
+}
+
+void DQAsyncWorker::stop(){
+    m_mutex.lock();
+    m_stopping = true;
+    QQueue<DQAsyncTask*> queue = m_queue;
+    m_queue.clear();
+    m_condition.wakeAll();
+    m_mutex.unlock();
+
+    foreach (DQAsyncTask *task , queue) {
+        task->discard();
+        delete task;
+    }
+
+    if (QThread::currentThread() != this)
+        wait();
+}
+
+void DQAsyncWorker::run(){
+    QString name = QString("dquest-async-%1").arg(m_workerCount.fetchAndAddOrdered(1));
+
+    {
+        QSqlDatabase db = QSqlDatabase::cloneDatabase(m_database,name);
+        DQConnection connection;
+
+        if (db.open()) {
+            connection.openClone(db,m_models);
+        } else {
+            qWarning() << QString("DQAsyncWorker::run() - Failed to open the database. Error : %1")
+                          .arg(db.lastError().text());
+        }
+
+        while (true) {
+            m_mutex.lock();
+            while (m_queue.isEmpty() && !m_stopping)
+                m_condition.wait(&m_mutex);
+
+            if (m_stopping) {
+                m_mutex.unlock();
+                break;
+            }
+
+            DQAsyncTask *task = m_queue.dequeue();
+            m_mutex.unlock();
+
+            if (task->isCanceled() || !connection.isOpen()) {
+                task->discard();
+            } else {
+                task->run(connection);
+            }
+            delete task;
+        }
+
+        connection.close();
+        db.close();
+    }
+
+    QSqlDatabase::removeDatabase(name);
+}
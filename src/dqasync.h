@@ -0,0 +1,78 @@
+#ifndef DQASYNC_H
+#define DQASYNC_H
+
+#include <QFuture>
+#include <QFutureInterface>
+#include <dqconnection.h>
+
+/// A task to be executed by the worker thread of DQConnection
+/**
+  DQConnection::runAsync() queues the task to a worker thread owned by
+  the connection. The worker thread has its own clone of the database , and the
+  tasks are executed one by one in the order of queuing.
+
+  @see DQAsyncResultTask
+ */
+
+class DQAsyncTask {
+public:
+    virtual ~DQAsyncTask();
+
+    /// Execute the task on the worker thread and report the result
+    /**
+      @param connection The connection of the worker thread
+     */
+    virtual void run(DQConnection connection) = 0;
+
+    /// Return TRUE if the task is canceled by user before it is started
+    virtual bool isCanceled() const = 0;
+
+    /// Report the task is canceled without running it
+    virtual void discard() = 0;
+};
+
+/// A DQAsyncTask that report its result via QFuture
+/**
+  Subclass should implement exec(). The future is started on construction. So
+  QFuture::waitForFinished() will wait for the queued task.
+
+  Cancel the future by QFuture::cancel() before the task is started , and it will be
+  dropped by the worker thread. A started task could not be canceled.
+ */
+
+template <typename T>
+class DQAsyncResultTask : public DQAsyncTask {
+public:
+    DQAsyncResultTask() {
+        m_interface.reportStarted();
+    }
+
+    /// The future of the result
+    QFuture<T> future() {
+        return m_interface.future();
+    }
+
+    virtual void run(DQConnection connection) {
+        T result = exec(connection);
+        m_interface.reportResult(result);
+        m_interface.reportFinished();
+    }
+
+    virtual bool isCanceled() const {
+        return m_interface.isCanceled();
+    }
+
+    virtual void discard() {
+        m_interface.reportCanceled();
+        m_interface.reportFinished();
+    }
+
+protected:
+    /// Execute the task and return the result
+    virtual T exec(DQConnection connection) = 0;
+
+private:
+    QFutureInterface<T> m_interface;
+};
+
+#endif // DQASYNC_H
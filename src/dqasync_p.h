@@ -0,0 +1,51 @@
+#ifndef DQASYNC_P_H
+#define DQASYNC_P_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QSqlDatabase>
+#include "dqasync.h"
+
+/// The worker thread of DQConnection for DQAsyncTask
+/**
+  It clones the database of the connection in the worker thread , and executes
+  the queued tasks in order.
+ */
+
+class DQAsyncWorker : public QThread {
+public:
+    /// Construct a worker for the database and registered models of a connection
+    DQAsyncWorker(QSqlDatabase database , QList<DQModelMetaInfo*> models);
+
+    /// Destructor. It will stop the thread.
+    ~DQAsyncWorker();
+
+    /// Queue a task. Ownership is taken.
+    void enqueue(DQAsyncTask *task);
+
+    /// Discard the queued tasks and stop the thread after the running task is finished
+    /**
+      If it is called by the worker thread itself , it will return without waiting.
+     */
+    void stop();
+
+protected:
+    void run();
+
+private:
+    QSqlDatabase m_database;
+
+    QList<DQModelMetaInfo*> m_models;
+
+    QMutex m_mutex;
+
+    QWaitCondition m_condition;
+
+    QQueue<DQAsyncTask*> m_queue;
+
+    bool m_stopping;
+};
+
+#endif // DQASYNC_P_H
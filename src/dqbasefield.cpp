@@ -3,7 +3,21 @@
 #include <QString>
 #include <QtCore>
 
-DQBaseField::DQBaseField()
+DQBaseFieldProxy::DQBaseFieldProxy(DQBaseField *field) : m_field(field) {
+    m_value = field->get();
+    m_original = m_value;
+}
+
+DQBaseFieldProxy::~DQBaseFieldProxy(){
+    if (m_value != m_original || m_value.isNull() != m_original.isNull())
+        m_field->set(m_value);
+}
+
+QVariant* DQBaseFieldProxy::operator->(){
+    return &m_value;
+}
+
+DQBaseField::DQBaseField() : m_modified(false)
 {
 }
 
@@ -12,13 +26,13 @@ DQBaseField::~DQBaseField()
 }
 
 bool DQBaseField::set(QVariant val){
-    m_value = val;
-    return true;
+    Q_UNUSED(val);
+    return false;
 }
 
 QVariant DQBaseField::get(bool convert) const {
     Q_UNUSED(convert);
-    return m_value;
+    return QVariant();
 }
 
 DQClause DQBaseField::clause(){
@@ -26,24 +40,38 @@ DQClause DQBaseField::clause(){
 }
 
 QVariant DQBaseField::operator=(const QVariant &val){
-    m_value = val;
+    set(val);
     return val;
 }
 
-QVariant* DQBaseField::operator->(){
-    return &m_value;
+DQBaseFieldProxy DQBaseField::operator->(){
+    return DQBaseFieldProxy(this);
 }
 
 QVariant DQBaseField::operator() () const {
-    return m_value;
+    return get();
 }
 
  DQBaseField::operator QVariant(){
-    return m_value;
+    return get();
 }
 
  void DQBaseField::clear(){
-    m_value.clear();
+    set(QVariant());
+    m_modified = true;
+ }
+
+ bool DQBaseField::isModified() const{
+     return m_modified;
+ }
+
+ void DQBaseField::setModified(bool modified){
+     m_modified = modified;
+ }
+
+ bool DQBaseField::setLinkedModel(QSharedPointer<DQAbstractModel> model){
+     Q_UNUSED(model);
+     return false;
  }
 
  QDebug operator<<(QDebug dbg, const DQBaseField &field){
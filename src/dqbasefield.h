@@ -2,18 +2,45 @@
 #define DQBASEFIELD_H
 
 #include <QSharedDataPointer>
+#include <QSharedPointer>
 #include <QVariant>
 #include <dqclause.h>
 
 class DQModel;
+class DQAbstractModel;
+
+class DQBaseField;
+
+/// A temporary copy of the value of a field returned by DQBaseField::operator->
+/**
+  The field do not store its value as QVariant. The modification on the copy is
+  written back to the field when the proxy is destroyed (the end of the expression).
+ */
+class DQBaseFieldProxy {
+public:
+    explicit DQBaseFieldProxy(DQBaseField *field);
+    ~DQBaseFieldProxy();
+
+    /// Provides access to the copy of value
+    QVariant* operator->();
+
+private:
+    DQBaseField *m_field;
+    QVariant m_value;
+    QVariant m_original;
+};
 
 /// The base class of DQField
+/**
+  DQBaseField is the type-erased interface of DQField. The value is stored by the
+  subclass in its native type. set() / get() convert it from / to QVariant.
+ */
 
 class DQBaseField
 {
 public:
     DQBaseField();
-    ~DQBaseField();
+    virtual ~DQBaseField();
 
     /// Assign value to the field
     virtual bool set(QVariant value);
@@ -33,8 +60,18 @@ public:
     /// Assign the value from a QVariant type source.
     virtual QVariant operator=(const QVariant &val);
 
-    /// Provides access to stored QVariant value
-    QVariant* operator->();
+    /// Provides access to a QVariant copy of the value
+    /**
+      As the value could be changed through the pointer , the field is marked as modified.
+      The changed value is written back at the end of the expression.
+
+      Example:
+\code
+    if (model.id->isNull()) {
+    }
+\endcode
+     */
+    DQBaseFieldProxy operator->();
 
     /// Get the value of the field
     QVariant operator() ()const;
@@ -45,10 +82,42 @@ public:
     /// Free up any resources used.
     void clear();
 
+    /// Return TRUE if the value is changed since it is loaded or saved
+    bool isModified() const;
+
+    /// Set the modified flag
+    void setModified(bool modified);
+
+    /// Set the model "linked" by this field
+    /**
+      It is only supported by DQForeignKey. The model will be shared with the field.
+
+      @return TRUE if the field take the model
+     */
+    virtual bool setLinkedModel(QSharedPointer<DQAbstractModel> model);
+
 private:
-    QVariant m_value;
+    bool m_modified;
 };
 
+/// Get the value of a field as QVariant. It is bound to the field type by DQ_FIELD.
+typedef QVariant (*_dqFieldGetFunc)(const DQBaseField *field, bool convert);
+
+/// Set the value of a field from QVariant. It is bound to the field type by DQ_FIELD.
+typedef bool (*_dqFieldSetFunc)(DQBaseField *field, const QVariant &value);
+
+/// Non-virtual call to F::get()
+template <typename F>
+QVariant _dqFieldGet(const DQBaseField *field, bool convert) {
+    return static_cast<const F*>(field)->F::get(convert);
+}
+
+/// Non-virtual call to F::set()
+template <typename F>
+bool _dqFieldSet(DQBaseField *field, const QVariant &value) {
+    return static_cast<F*>(field)->F::set(value);
+}
+
 QDebug operator<<(QDebug dbg, const DQBaseField &field);
 
 
@@ -0,0 +1,387 @@
+#include <QtCore>
+#include "dqcolumnset.h"
+
+/// The initial capacity of the null bitmap
+#define DQ_COLUMN_NULLS_CAPACITY 1024
+
+/* Kernels over a contiguous vector. The loop without null is free of branch , so it could be vectorized by compiler. */
+
+/// Sum of an integer column. A null value is stored as zero , so it needs no check.
+/**
+  The values are widened to qint64 , so the sum of an int column will not overflow.
+ */
+template <typename T>
+static qint64 _dqColumnIntegerSum(const T* data , int n) {
+    qint64 res = 0;
+    for (int i = 0 ; i < n ; i++)
+        res += data[i];
+    return res;
+}
+
+/// Sum of a double column. A null value is stored as zero , so it needs no check.
+/**
+  The floating point addition is not associative , so the compiler will not reorder a
+  single accumulator. The independent partial sums could be vectorized.
+ */
+static double _dqColumnDoubleSum(const double* data , int n) {
+    double s0 = 0 , s1 = 0 , s2 = 0 , s3 = 0;
+    int i = 0;
+
+    for ( ; i + 4 <= n ; i += 4) {
+        s0 += data[i];
+        s1 += data[i + 1];
+        s2 += data[i + 2];
+        s3 += data[i + 3];
+    }
+
+    for ( ; i < n ; i++)
+        s0 += data[i];
+
+    return (s0 + s1) + (s2 + s3);
+}
+
+/// Find the min (or max) non-null value. Return FALSE if there has no value.
+template <typename T>
+static bool _dqColumnMinMax(const T* data , int n , const QBitArray& nulls , int nullCount , bool findMax , T& res) {
+    int i = 0;
+
+    if (nullCount > 0) {
+        while (i < n && nulls.testBit(i))
+            i++;
+    }
+
+    if (i >= n)
+        return false;
+
+    T value = data[i];
+
+    if (nullCount == 0) {
+        if (findMax) {
+            for ( ; i < n ; i++)
+                value = data[i] > value ? data[i] : value;
+        } else {
+            for ( ; i < n ; i++)
+                value = data[i] < value ? data[i] : value;
+        }
+    } else {
+        for ( ; i < n ; i++) {
+            if (nulls.testBit(i))
+                continue;
+            if (findMax ? data[i] > value : data[i] < value)
+                value = data[i];
+        }
+    }
+
+    res = value;
+    return true;
+}
+
+template <typename T>
+static void _dqColumnHistogram(const T* data , int n , const QBitArray& nulls , int nullCount ,
+                               double lower , double upper , QVector<int>& bins) {
+    int size = bins.size();
+    int *counts = bins.data();
+    double scale = size / (upper - lower);
+
+    for (int i = 0 ; i < n ; i++) {
+        if (nullCount > 0 && nulls.testBit(i))
+            continue;
+
+        double v = data[i];
+        if (v < lower || v > upper)
+            continue;
+
+        int bin = (int) ((v - lower) * scale);
+        if (bin >= size)
+            bin = size - 1;
+        counts[bin]++;
+    }
+}
+
+/* DQColumn */
+
+DQColumn::DQColumn() : m_type(QVariant::Invalid) , m_storage(VariantStorage) , m_size(0) , m_nullCount(0) {
+}
+
+DQColumn::DQColumn(QString name , QVariant::Type type) :
+    m_name(name) ,
+    m_type(type) ,
+    m_size(0) ,
+    m_nullCount(0)
+{
+    switch (type) {
+    case QVariant::Int:
+    case QVariant::Bool:
+        m_storage = IntStorage;
+        break;
+    case QVariant::UInt:
+    case QVariant::LongLong:
+        // qint64 holds all the values of UInt
+        m_storage = LongLongStorage;
+        break;
+    case QVariant::Double:
+        m_storage = DoubleStorage;
+        break;
+    default:
+        m_storage = VariantStorage;
+        break;
+    }
+}
+
+QString DQColumn::name() const {
+    return m_name;
+}
+
+QVariant::Type DQColumn::type() const {
+    return m_type;
+}
+
+int DQColumn::size() const {
+    return m_size;
+}
+
+bool DQColumn::isNumeric() const {
+    return m_storage != VariantStorage;
+}
+
+bool DQColumn::isNull(int row) const {
+    return m_nullCount > 0 && m_nulls.testBit(row);
+}
+
+int DQColumn::nullCount() const {
+    return m_nullCount;
+}
+
+const QBitArray& DQColumn::nulls() const {
+    return m_nulls;
+}
+
+const QVector<int>& DQColumn::ints() const {
+    return m_ints;
+}
+
+const QVector<qint64>& DQColumn::longLongs() const {
+    return m_longLongs;
+}
+
+const QVector<double>& DQColumn::doubles() const {
+    return m_doubles;
+}
+
+const QVector<QVariant>& DQColumn::variants() const {
+    return m_variants;
+}
+
+QVariant DQColumn::value(int row) const {
+    if (isNull(row))
+        return QVariant(m_type);
+
+    QVariant res;
+    switch (m_storage) {
+    case IntStorage:
+        res = m_ints.at(row);
+        break;
+    case LongLongStorage:
+        res = m_longLongs.at(row);
+        break;
+    case DoubleStorage:
+        res = m_doubles.at(row);
+        break;
+    default:
+        return m_variants.at(row);
+    }
+
+    res.convert(m_type);
+    return res;
+}
+
+double DQColumn::sum() const {
+    double res = 0;
+    switch (m_storage) {
+    case IntStorage:
+        res = _dqColumnIntegerSum(m_ints.constData(),m_size);
+        break;
+    case LongLongStorage:
+        res = _dqColumnIntegerSum(m_longLongs.constData(),m_size);
+        break;
+    case DoubleStorage:
+        res = _dqColumnDoubleSum(m_doubles.constData(),m_size);
+        break;
+    default:
+        break;
+    }
+    return res;
+}
+
+QVariant DQColumn::min() const {
+    QVariant res;
+    int i;
+    qint64 ll;
+    double d;
+
+    switch (m_storage) {
+    case IntStorage:
+        if (_dqColumnMinMax(m_ints.constData(),m_size,m_nulls,m_nullCount,false,i))
+            res = i;
+        break;
+    case LongLongStorage:
+        if (_dqColumnMinMax(m_longLongs.constData(),m_size,m_nulls,m_nullCount,false,ll))
+            res = ll;
+        break;
+    case DoubleStorage:
+        if (_dqColumnMinMax(m_doubles.constData(),m_size,m_nulls,m_nullCount,false,d))
+            res = d;
+        break;
+    default:
+        break;
+    }
+    return res;
+}
+
+QVariant DQColumn::max() const {
+    QVariant res;
+    int i;
+    qint64 ll;
+    double d;
+
+    switch (m_storage) {
+    case IntStorage:
+        if (_dqColumnMinMax(m_ints.constData(),m_size,m_nulls,m_nullCount,true,i))
+            res = i;
+        break;
+    case LongLongStorage:
+        if (_dqColumnMinMax(m_longLongs.constData(),m_size,m_nulls,m_nullCount,true,ll))
+            res = ll;
+        break;
+    case DoubleStorage:
+        if (_dqColumnMinMax(m_doubles.constData(),m_size,m_nulls,m_nullCount,true,d))
+            res = d;
+        break;
+    default:
+        break;
+    }
+    return res;
+}
+
+double DQColumn::mean() const {
+    int n = m_size - m_nullCount;
+    if (n <= 0 || !isNumeric())
+        return 0;
+    return sum() / n;
+}
+
+QVector<int> DQColumn::histogram(int bins , double lower , double upper) const {
+    QVector<int> res(qMax(bins,0),0);
+    if (bins <= 0 || upper <= lower)
+        return res;
+
+    switch (m_storage) {
+    case IntStorage:
+        _dqColumnHistogram(m_ints.constData(),m_size,m_nulls,m_nullCount,lower,upper,res);
+        break;
+    case LongLongStorage:
+        _dqColumnHistogram(m_longLongs.constData(),m_size,m_nulls,m_nullCount,lower,upper,res);
+        break;
+    case DoubleStorage:
+        _dqColumnHistogram(m_doubles.constData(),m_size,m_nulls,m_nullCount,lower,upper,res);
+        break;
+    default:
+        break;
+    }
+
+    return res;
+}
+
+void DQColumn::append(const QVariant& value){
+    bool null = value.isNull();
+
+    if (null) {
+        if (m_nulls.size() <= m_size)
+            m_nulls.resize(qMax(m_nulls.size() * 2,qMax(m_size + 1,DQ_COLUMN_NULLS_CAPACITY)));
+        m_nulls.setBit(m_size);
+        m_nullCount++;
+    }
+
+    switch (m_storage) {
+    case IntStorage:
+        m_ints.append(null ? 0 : value.toInt());
+        break;
+    case LongLongStorage:
+        m_longLongs.append(null ? 0 : value.toLongLong());
+        break;
+    case DoubleStorage:
+        m_doubles.append(null ? 0 : value.toDouble());
+        break;
+    default:
+        if (null) {
+            m_variants.append(QVariant());
+        } else {
+            QVariant v = value;
+            v.convert(m_type);
+            m_variants.append(v);
+        }
+        break;
+    }
+
+    m_size++;
+}
+
+void DQColumn::squeeze(){
+    m_nulls.resize(m_size);
+    m_ints.squeeze();
+    m_longLongs.squeeze();
+    m_doubles.squeeze();
+    m_variants.squeeze();
+}
+
+/* DQColumnSet */
+
+DQColumnSet::DQColumnSet() {
+}
+
+int DQColumnSet::rowCount() const {
+    if (m_columns.isEmpty())
+        return 0;
+    return m_columns.first().size();
+}
+
+int DQColumnSet::columnCount() const {
+    return m_columns.size();
+}
+
+QStringList DQColumnSet::names() const {
+    QStringList res;
+    foreach (const DQColumn& column , m_columns) {
+        res << column.name();
+    }
+    return res;
+}
+
+int DQColumnSet::indexOf(QString name) const {
+    return m_index.value(name,-1);
+}
+
+const DQColumn& DQColumnSet::column(int index) const {
+    if (index < 0 || index >= m_columns.size())
+        return m_empty;
+    return m_columns.at(index);
+}
+
+const DQColumn& DQColumnSet::column(QString name) const {
+    return column(indexOf(name));
+}
+
+void DQColumnSet::addColumn(QString name , QVariant::Type type){
+    m_index[name] = m_columns.size();
+    m_columns.append(DQColumn(name,type));
+}
+
+void DQColumnSet::append(int index , const QVariant& value){
+    m_columns[index].append(value);
+}
+
+void DQColumnSet::squeeze(){
+    for (int i = 0 ; i < m_columns.size();i++) {
+        m_columns[i].squeeze();
+    }
+}
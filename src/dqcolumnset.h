@@ -0,0 +1,189 @@
+#ifndef DQCOLUMNSET_H
+#define DQCOLUMNSET_H
+
+#include <QVariant>
+#include <QVector>
+#include <QBitArray>
+#include <QStringList>
+#include <QHash>
+
+/// A column of DQColumnSet
+/**
+  The values are stored in a contiguous vector of its native type:
+
+  - QVariant::Int and QVariant::Bool are stored in ints()
+  - QVariant::UInt and QVariant::LongLong are stored in longLongs()
+  - QVariant::Double is stored in doubles()
+  - Other types , including QVariant::ULongLong , are stored in variants()
+
+  QVariant::ULongLong is not stored in longLongs() , as a value larger than the max. of
+  qint64 would wrap around. It is not numeric , so the kernels do not apply on it.
+
+  A null value is stored as zero (or null QVariant) and marked in nulls().
+
+  The numeric kernels (sum() , min() , max() , mean() , histogram()) skip the null values.
+  They are written as plain loops over the vector , such that the compiler could
+  vectorize them.
+ */
+
+class DQColumn {
+public:
+    /// Construct an empty column
+    DQColumn();
+
+    /// Construct an empty column of the field
+    DQColumn(QString name , QVariant::Type type);
+
+    /// The field name
+    QString name() const;
+
+    /// The type of field
+    QVariant::Type type() const;
+
+    /// No. of values
+    int size() const;
+
+    /// Returns TRUE if it is stored in ints() , longLongs() or doubles()
+    bool isNumeric() const;
+
+    /// Returns TRUE if the value at row is null
+    bool isNull(int row) const;
+
+    /// No. of null values
+    int nullCount() const;
+
+    /// The null bitmap. The bit is set if the value of the row is null.
+    const QBitArray& nulls() const;
+
+    /// The values of integer column
+    const QVector<int>& ints() const;
+
+    /// The values of 64-bit integer column
+    const QVector<qint64>& longLongs() const;
+
+    /// The values of floating point column
+    const QVector<double>& doubles() const;
+
+    /// The values of other column
+    const QVector<QVariant>& variants() const;
+
+    /// Returns the value at row as QVariant
+    QVariant value(int row) const;
+
+    /// The sum of non-null values. 0 if it is not numeric.
+    /**
+      The integer values are accumulated in qint64 , so the sum of an int column will not
+      overflow before it is converted to double.
+     */
+    double sum() const;
+
+    /// The minimum non-null value. A null QVariant is returned if there has no value.
+    QVariant min() const;
+
+    /// The maximum non-null value. A null QVariant is returned if there has no value.
+    QVariant max() const;
+
+    /// The mean of non-null values. 0 if there has no value.
+    double mean() const;
+
+    /// Count the non-null values in bins of equal width between lower and upper
+    /**
+      @param bins No. of bins
+      @param lower The lower bound of first bin
+      @param upper The upper bound of last bin. The values equal to upper is counted in last bin.
+
+      The values out of range are not counted.
+     */
+    QVector<int> histogram(int bins , double lower , double upper) const;
+
+private:
+    /// Append a value read from database
+    void append(const QVariant& value);
+
+    /// Release the unused capacity and fix the size of null bitmap
+    void squeeze();
+
+    enum Storage {
+        IntStorage,
+        LongLongStorage,
+        DoubleStorage,
+        VariantStorage
+    };
+
+    QString m_name;
+    QVariant::Type m_type;
+    Storage m_storage;
+
+    int m_size;
+    int m_nullCount;
+    QBitArray m_nulls;
+
+    QVector<int> m_ints;
+    QVector<qint64> m_longLongs;
+    QVector<double> m_doubles;
+    QVector<QVariant> m_variants;
+
+    friend class DQColumnSet;
+};
+
+/// Columnar (struct-of-arrays) result of a query
+/**
+  It is created by DQSharedQuery::columns(). Instead of a model per record , it
+  holds a contiguous vector per field. It is useful for aggregation in C++ over
+  a large result.
+
+Example code:
+\code
+    DQColumnSet set = DQQuery<HealthCheck>().columns(QStringList() << "height" << "weight");
+
+    qDebug() << set.column("height").mean();
+    qDebug() << set.column("weight").histogram(10,0,100);
+
+    const QVector<int>& heights = set.column("height").ints();
+\endcode
+
+ */
+
+class DQColumnSet {
+public:
+    /// Construct an empty column set
+    DQColumnSet();
+
+    /// No. of rows
+    int rowCount() const;
+
+    /// No. of columns
+    int columnCount() const;
+
+    /// The field names of columns
+    QStringList names() const;
+
+    /// The index of column of the field. -1 if it is not found
+    int indexOf(QString name) const;
+
+    /// Returns the column at index
+    const DQColumn& column(int index) const;
+
+    /// Returns the column of the field. An empty column is returned if it is not found.
+    const DQColumn& column(QString name) const;
+
+private:
+    /// Add a column for the field
+    void addColumn(QString name , QVariant::Type type);
+
+    /// Append a value to the column
+    void append(int index , const QVariant& value);
+
+    /// Finish the reading of rows
+    void squeeze();
+
+    QList<DQColumn> m_columns;
+
+    QHash<QString,int> m_index;
+
+    DQColumn m_empty;
+
+    friend class DQSharedQuery;
+};
+
+#endif // DQCOLUMNSET_H
@@ -8,17 +8,90 @@
 #include "dqconnection.h"
 #include "dqsqlitestatement.h"
 #include "dqsql.h"
+#include "dqconnectionpool.h"
+#include "dqasync_p.h"
+
+/* A worker could not wait and delete itself. If it is stopped by its own task , it is
+   retired to this list , and deleted by the other threads once it is finished.
+ */
+static QMutex m_retiredWorkersMutex;
+static QList<DQAsyncWorker*> m_retiredWorkers;
+static bool m_retiredWorkersRoutineAdded = false;
+
+/// Delete the retired workers. If wait is FALSE , only the finished workers are deleted.
+static void deleteRetiredWorkers(bool wait) {
+    QList<DQAsyncWorker*> workers;
+
+    m_retiredWorkersMutex.lock();
+    foreach (DQAsyncWorker *w , m_retiredWorkers) {
+        if (w == QThread::currentThread())
+            continue;
+        if (wait || w->isFinished())
+            workers << w;
+    }
+    foreach (DQAsyncWorker *w , workers) {
+        m_retiredWorkers.removeOne(w);
+    }
+    m_retiredWorkersMutex.unlock();
+
+    // The destructor waits the thread
+    foreach (DQAsyncWorker *w , workers) {
+        delete w;
+    }
+}
+
+/// Delete all the retired workers on application exit
+static void deleteRetiredWorkersOnExit() {
+    deleteRetiredWorkers(true);
+}
+
+/// Retire a worker stopped by its own task
+static void retireWorker(DQAsyncWorker *worker) {
+    QMutexLocker locker(&m_retiredWorkersMutex);
+    m_retiredWorkers << worker;
+
+    if (!m_retiredWorkersRoutineAdded) {
+        qAddPostRoutine(deleteRetiredWorkersOnExit);
+        m_retiredWorkersRoutineAdded = true;
+    }
+}
 
 class DQConnectionPriv : public QSharedData
 {
   public:
     DQConnectionPriv() {
         lastQuery = 0;
+        worker = 0;
     }
 
     ~DQConnectionPriv() {
         if (lastQuery)
             delete lastQuery;
+        stopWorker();
+    }
+
+    /// Stop and release the worker thread
+    void stopWorker() {
+        // Do not hold the mutex while waiting the running task
+        mutex.lock();
+        DQAsyncWorker *w = worker;
+        worker = 0;
+        mutex.unlock();
+
+        if (!w)
+            return;
+
+        w->stop();
+
+        if (QThread::currentThread() == w) {
+            // Called by a task of the worker. The thread may not have an event loop , so it
+            // is deleted by another thread after its run() is returned.
+            retireWorker(w);
+        } else {
+            delete w;
+        }
+
+        deleteRetiredWorkers(false);
     }
 
     DQSql m_sql;
@@ -30,6 +103,9 @@ class DQConnectionPriv : public QSharedData
     QSqlQuery *lastQuery;
 
     QMutex mutex;
+
+    /// The worker thread of runAsync(). It is created on demand.
+    DQAsyncWorker *worker;
 };
 
 /// The default connection shared for all objects
@@ -82,11 +158,33 @@ bool DQConnection::open(QSqlDatabase db){
     return true;
 }
 
+bool DQConnection::openClone(QSqlDatabase db,const DQConnection& source){
+    Q_ASSERT(db.isOpen());
+
+    d->m_sql.setStatement(new DQSqliteStatement());
+    d->m_sql.setDatabase(db);
+    d->m_models = source.d->m_models;
+
+    return true;
+}
+
+bool DQConnection::openClone(QSqlDatabase db,QList<DQModelMetaInfo*> models){
+    Q_ASSERT(db.isOpen());
+
+    d->m_sql.setStatement(new DQSqliteStatement());
+    d->m_sql.setDatabase(db);
+    d->m_models = models;
+
+    return true;
+}
+
 bool DQConnection::isOpen(){
     return d->m_sql.database().isOpen();
 }
 
 void DQConnection::close(){
+    stopAsync();
+
     if (d->lastQuery) {
         delete d->lastQuery;
         d->lastQuery = 0;
@@ -108,6 +206,9 @@ bool DQConnection::addModel(DQModelMetaInfo* metaInfo){
 }
 
 DQConnection DQConnection::defaultConnection(){
+    DQConnectionPool *pool = DQConnectionPool::defaultPool();
+    if (pool && pool->isOpen())
+        return pool->connection();
     return m_defaultConnection;
 }
 
@@ -134,10 +235,7 @@ bool DQConnection::createTables(){
             }
 
             DQSharedList initialData = info->initialData();
-            int n = initialData.size();
-            for (int i = 0 ; i< n;i++) {
-                initialData.at(i)->save();
-            }
+            initialData.save();
         }
     }
 
@@ -170,6 +268,10 @@ bool DQConnection::dropIndex(QString name){
     return d->m_sql.dropIndexIfExists(name);
 }
 
+DQTransaction DQConnection::transaction(){
+    return DQTransaction(*this);
+}
+
 DQSql& DQConnection::sql(){
     return d->m_sql;
 }
@@ -178,6 +280,22 @@ QSqlQuery DQConnection::query(){
     return d->m_sql.query();
 }
 
+void DQConnection::setStatementCacheCapacity(int capacity){
+    d->m_sql.setStatementCacheCapacity(capacity);
+}
+
+int DQConnection::statementCacheCapacity(){
+    return d->m_sql.statementCacheCapacity();
+}
+
+int DQConnection::statementCacheHits(){
+    return d->m_sql.statementCacheHits();
+}
+
+int DQConnection::statementCacheMisses(){
+    return d->m_sql.statementCacheMisses();
+}
+
 void DQConnection::setLastQuery(QSqlQuery query){
     d->mutex.lock();
     if (d->lastQuery != 0)
@@ -195,8 +313,46 @@ QSqlQuery DQConnection::lastQuery(){
      */
     QSqlQuery query;
     d->mutex.lock();
-    query = *d->lastQuery;
+    if (d->lastQuery)
+        query = *d->lastQuery;
     d->mutex.unlock();
 
     return query;
 }
+
+/// Returns TRUE if the database could not be shared by a clone. e.g An in-memory database
+static bool isPrivateDatabase(QSqlDatabase db){
+    QString name = db.databaseName();
+    return name.isEmpty() || name == ":memory:";
+}
+
+void DQConnection::runAsync(DQAsyncTask *task){
+    d->mutex.lock();
+    if (!d->worker) {
+        if (!isOpen()) {
+            d->mutex.unlock();
+            qWarning() << "DQConnection::runAsync() - The connection is not opened.";
+            task->discard();
+            delete task;
+            return;
+        }
+
+        if (isPrivateDatabase(d->m_sql.database())) {
+            d->mutex.unlock();
+            qWarning() << "DQConnection::runAsync() - An in-memory or temporary database could not be used by the worker thread.";
+            task->discard();
+            delete task;
+            return;
+        }
+        deleteRetiredWorkers(false);
+
+        d->worker = new DQAsyncWorker(d->m_sql.database(),d->m_models);
+        d->worker->start();
+    }
+    d->worker->enqueue(task);
+    d->mutex.unlock();
+}
+
+void DQConnection::stopAsync(){
+    d->stopWorker();
+}
@@ -9,10 +9,12 @@
 
 #include <dqmodelmetainfo.h>
 #include <dqindex.h>
+#include <dqtransaction.h>
 
 class DQModelMetaInfo;
 class DQSql;
 class DQConnectionPriv;
+class DQAsyncTask;
 template <typename T> inline DQModelMetaInfo* dqMetaInfo();
 
 /// Connection to QSqlDatabase
@@ -26,8 +28,8 @@ template <typename T> inline DQModelMetaInfo* dqMetaInfo();
   store all the supported model , and return a DQSql object to this database for more advanced
   database operation.
 
-  @todo Thread-safe implemention.
   @remarks It is an explicitly shared class
+  @remarks A connection should only be used by the thread that opened it. Use DQConnectionPool for multi-threaded access.
 
 
 Example code:
@@ -132,6 +134,9 @@ public:
 
         qDebug() << d.isOpen(); // The result will become true , both of "c" and "d" are also the default connection.
 \endcode
+
+        If there has a default DQConnectionPool , it will return the connection of the calling thread
+        from the pool instead.
      */
     static DQConnection defaultConnection();
 
@@ -153,12 +158,36 @@ public:
 
     bool dropIndex(QString name);
 
+    /// Start a transaction
+    /**
+      If there has an active transaction on this connection , it will be a nested transaction (savepoint).
+      The transaction is rolled back on destruction unless DQTransaction::commit() is called.
+     */
+    DQTransaction transaction();
+
     /// Get the SQL interface that you may run predefined sql operations on the database
     DQSql& sql();
 
     /// Create a QSqlQuery object to the connected database
     QSqlQuery query();
 
+    /// Set the max. no. of prepared queries cached by this connection
+    /**
+      DQModel::save() , load() , remove() and DQQuery reuse the prepared queries
+      with the same SQL instead of preparing them again. The default capacity is 64.
+      Zero disables the cache.
+     */
+    void setStatementCacheCapacity(int capacity);
+
+    /// The max. no. of prepared queries cached by this connection
+    int statementCacheCapacity();
+
+    /// No. of prepared queries reused from the statement cache
+    int statementCacheHits();
+
+    /// No. of prepared queries that is not found in the statement cache
+    int statementCacheMisses();
+
     /// The last query with error used by DQConnection
     /**
       @threadsafe
@@ -174,6 +203,24 @@ public:
      */
     void setLastQuery(QSqlQuery query);
 
+    /// Run a task on the worker thread of this connection
+    /**
+      The worker thread is started on first call. It owns a clone of the database, and
+      the tasks are executed in the order of queuing. The ownership of task is taken.
+
+      The worker thread is stopped by close(). The tasks not yet started are canceled.
+
+      The clone is a separated connection to the database file. It does not see the
+      uncommitted changes of a DQTransaction on this connection , and the changes of a task
+      are not rolled back by it.
+
+      A clone of an in-memory (":memory:") or temporary database would be a new empty
+      database. Such a database is refused with a warning , and the task is canceled.
+
+      @see DQSharedQuery::allAsync() , DQModel::saveAsync()
+     */
+    void runAsync(DQAsyncTask *task);
+
 signals:
 
 public slots:
@@ -181,8 +228,26 @@ public slots:
 protected:
 
 private:
+    /// Open the connection with a cloned database of source
+    /**
+      It copies the registered models from source. It will never become the default connection.
+     */
+    bool openClone(QSqlDatabase db,const DQConnection& source);
+
+    /// Open the connection with a cloned database and the registered models
+    bool openClone(QSqlDatabase db,QList<DQModelMetaInfo*> models);
+
+    /// Stop the worker thread of runAsync()
+    /**
+      If it is called by a task of the worker , the thread is deleted by another thread
+      after the task is returned.
+     */
+    void stopAsync();
 
     QExplicitlySharedDataPointer<DQConnectionPriv> d;
+
+    friend class DQConnectionPool;
+    friend class DQAsyncWorker;
 };
 
 #endif // DQCONNECTION_H
@@ -0,0 +1,267 @@
+#include <QtCore>
+#include <QThread>
+#include <QThreadStorage>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QSqlError>
+
+#include "dqconnectionpool.h"
+#include "dqsql.h"
+
+/// The id of closed pools which still have clones. It is removed with the last clone.
+static QSet<int> m_closedPools;
+
+/// Pool id to the no. of its clones in all threads
+static QMap<int,int> m_poolClones;
+
+static QMutex m_closedPoolsMutex;
+
+/// Count off a released clone of a pool
+static void releaseClone(int id) {
+    m_closedPoolsMutex.lock();
+    if (--m_poolClones[id] <= 0) {
+        m_poolClones.remove(id);
+        m_closedPools.remove(id);
+    }
+    m_closedPoolsMutex.unlock();
+}
+
+/// The thread-local connections owned by a thread
+/**
+  It is destroyed by QThreadStorage when the thread exits.
+ */
+class DQConnectionPoolLocal {
+public:
+    ~DQConnectionPoolLocal() {
+        foreach (int id , connections.keys()) {
+            remove(id);
+        }
+    }
+
+    /// Close and remove the cloned database of a pool
+    void remove(int id) {
+        DQConnection connection = connections.take(id);
+        connection.close();
+        connection = DQConnection();
+
+        QString name = names.take(id);
+        {
+            QSqlDatabase db = QSqlDatabase::database(name,false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+
+        releaseClone(id);
+    }
+
+    /// Remove the connections of closed pools
+    /**
+      A QSqlDatabase could only be closed by its own thread. So the pool could not
+      close the clones on close() , it is done on the next call of connection() in the thread.
+     */
+    void removeClosed() {
+        QList<int> closed;
+
+        m_closedPoolsMutex.lock();
+        foreach (int id , connections.keys()) {
+            if (m_closedPools.contains(id))
+                closed << id;
+        }
+        m_closedPoolsMutex.unlock();
+
+        foreach (int id , closed) {
+            remove(id);
+        }
+    }
+
+    /// Pool id to connection
+    QMap<int, DQConnection> connections;
+
+    /// Pool id to the name of the cloned database
+    QMap<int, QString> names;
+};
+
+class DQConnectionPoolPriv {
+public:
+    DQConnectionPoolPriv() {
+        opened = false;
+        thread = 0;
+        serial = 0;
+    }
+
+    /// Unique id of the pool
+    int id;
+
+    bool opened;
+
+    /// The source connection
+    DQConnection connection;
+
+    /// The database to be cloned
+    QSqlDatabase database;
+
+    /// The thread that opened the pool
+    QThread *thread;
+
+    /// No. of cloned database.
+    int serial;
+
+    QMutex mutex;
+};
+
+static QThreadStorage<DQConnectionPoolLocal*> m_localConnections;
+
+static QAtomicInt m_poolCount;
+
+static DQConnectionPool *m_defaultPool = 0;
+
+static QMutex m_defaultPoolMutex;
+
+DQConnectionPool::DQConnectionPool()
+{
+    d = new DQConnectionPoolPriv();
+    d->id = m_poolCount.fetchAndAddOrdered(1);
+}
+
+DQConnectionPool::~DQConnectionPool(){
+    close();
+    delete d;
+}
+
+bool DQConnectionPool::open(DQConnection connection){
+    if (!connection.isOpen()) {
+        qWarning() << "DQConnectionPool::open() - The connection is not opened";
+        return false;
+    }
+
+    d->mutex.lock();
+    d->connection = connection;
+    d->database = connection.sql().database();
+    d->thread = QThread::currentThread();
+    d->opened = true;
+    d->mutex.unlock();
+
+    m_defaultPoolMutex.lock();
+    if (m_defaultPool == 0)
+        m_defaultPool = this; // The first opened pool become the default pool
+    m_defaultPoolMutex.unlock();
+
+    return true;
+}
+
+void DQConnectionPool::close(){
+    m_defaultPoolMutex.lock();
+    if (m_defaultPool == this)
+        m_defaultPool = 0;
+    m_defaultPoolMutex.unlock();
+
+    d->mutex.lock();
+    bool opened = d->opened;
+    d->opened = false;
+    d->connection = DQConnection();
+    d->database = QSqlDatabase();
+    d->thread = 0;
+    d->mutex.unlock();
+
+    if (!opened)
+        return;
+
+    // The clones created since open() are released by their threads
+    m_closedPoolsMutex.lock();
+    if (m_poolClones.contains(d->id))
+        m_closedPools.insert(d->id);
+    m_closedPoolsMutex.unlock();
+
+    d->mutex.lock();
+    d->id = m_poolCount.fetchAndAddOrdered(1);
+    d->mutex.unlock();
+}
+
+bool DQConnectionPool::isOpen(){
+    QMutexLocker locker(&d->mutex);
+    return d->opened;
+}
+
+DQConnection DQConnectionPool::connection(){
+    int id;
+    QThread *thread;
+    DQConnection source;
+
+    d->mutex.lock();
+    bool opened = d->opened;
+    id = d->id;
+    thread = d->thread;
+    source = d->connection;
+    d->mutex.unlock();
+
+    if (!opened) {
+        return DQConnection();
+    }
+
+    if (QThread::currentThread() == thread) {
+        return source;
+    }
+
+    if (!m_localConnections.hasLocalData()) {
+        m_localConnections.setLocalData(new DQConnectionPoolLocal());
+    }
+
+    DQConnectionPoolLocal *local = m_localConnections.localData();
+    local->removeClosed();
+
+    if (local->connections.contains(id)) {
+        return local->connections.value(id);
+    }
+
+    QSqlDatabase db;
+    QString name;
+
+    d->mutex.lock();
+    if (!d->opened || d->id != id) {
+        // Closed by another thread
+        d->mutex.unlock();
+        return DQConnection();
+    }
+    name = QString("dquest-pool-%1-%2").arg(id).arg(d->serial++);
+    db = QSqlDatabase::cloneDatabase(d->database,name);
+    source = d->connection;
+
+    // Counted before the pool could be closed
+    m_closedPoolsMutex.lock();
+    m_poolClones[id]++;
+    m_closedPoolsMutex.unlock();
+    d->mutex.unlock();
+
+    DQConnection connection;
+
+    if (!db.open()) {
+        qWarning() << QString("DQConnectionPool::connection() - Failed to open the database for thread. Error : %1")
+                      .arg(db.lastError().text());
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+
+        releaseClone(id);
+        return connection;
+    }
+
+    connection.openClone(db,source);
+
+    local->connections[id] = connection;
+    local->names[id] = name;
+
+    return connection;
+}
+
+void DQConnectionPool::setToDefaultPool(){
+    m_defaultPoolMutex.lock();
+    m_defaultPool = this;
+    m_defaultPoolMutex.unlock();
+}
+
+DQConnectionPool* DQConnectionPool::defaultPool(){
+    DQConnectionPool *pool;
+    m_defaultPoolMutex.lock();
+    pool = m_defaultPool;
+    m_defaultPoolMutex.unlock();
+    return pool;
+}
@@ -0,0 +1,94 @@
+#ifndef DQCONNECTIONPOOL_H
+#define DQCONNECTIONPOOL_H
+
+#include <QSqlDatabase>
+#include <dqconnection.h>
+
+class DQConnectionPoolPriv;
+
+/// Per-thread connection pool
+/**
+  QSqlDatabase can only be used by the thread that created it. Therefore
+  a single DQConnection could not be shared by multiple thread.
+
+  DQConnectionPool solves this problem by cloning the database of an opened
+  DQConnection (QSqlDatabase::cloneDatabase) for every thread that ask for
+  a connection. The cloned connection is stored in thread-local storage ,
+  and it will be closed and removed when the thread exits.
+
+  The first opened pool become the "default pool". Once there has a default pool,
+  DQConnection::defaultConnection() will return the connection of the calling thread.
+  So DQModel and DQQuery created in a worker thread (e.g QThreadPool) will use the
+  thread-local connection automatically. The thread which opened the pool will
+  still use the original connection.
+
+Example code:
+\code
+
+    DQConnection connection;
+    connection.open(db);
+    connection.addModel<HealthCheck>();
+
+    DQConnectionPool pool;
+    pool.open(connection); // It become the default pool
+
+    // Any thread could call DQModel::save() / load() now.
+
+\endcode
+
+  @remarks The database must be a file. A SQLite in-memory database could not be cloned.
+  @remarks Models should be registered by DQConnection::addModel() before the pool is opened.
+  @remarks A QSqlDatabase could only be closed by its own thread. After the pool is closed , the thread-local
+  connection is removed when its thread exits or calls connection() of any pool again. An idle thread
+  of QThreadPool keeps the database handle until then.
+ */
+
+class DQConnectionPool
+{
+public:
+    /// Constructs a new DQConnectionPool object
+    explicit DQConnectionPool();
+
+    /// Destructor. It will close the pool.
+    ~DQConnectionPool();
+
+    /// Open the pool
+    /**
+      @param connection An opened connection. Its database will be cloned for every thread. The registered models will be copied.
+      @return TRUE if the pool is opened
+     */
+    bool open(DQConnection connection);
+
+    /// Close the pool
+    /**
+      The pool could be opened again. The connections cloned before are not reused.
+     */
+    void close();
+
+    /// Return TRUE if the pool is opened
+    bool isOpen();
+
+    /// Get the connection of the calling thread
+    /**
+      If the calling thread is the thread that opened the pool , it will return the
+      original connection passed to open(). Otherwise a thread-local connection
+      will be returned. It is created on the first call in that thread.
+     */
+    DQConnection connection();
+
+    /// Change this pool to be the default pool
+    void setToDefaultPool();
+
+    /// Get the default pool
+    /**
+      @return The default pool or NULL if there has no any opened pool.
+     */
+    static DQConnectionPool* defaultPool();
+
+private:
+    Q_DISABLE_COPY(DQConnectionPool)
+
+    DQConnectionPoolPriv *d;
+};
+
+#endif // DQCONNECTIONPOOL_H
@@ -0,0 +1,149 @@
+#ifndef DQCURSOR_H
+#define DQCURSOR_H
+
+#include <dqsharedquery.h>
+
+/// A forward-only cursor over the result of a query
+/**
+  DQQuery::all() creates a model instance for every record and keeps all of them
+  in a DQList. DQCursor reads the records one by one into a single model instance
+  instead , so that the memory usage is constant no matter how many records are
+  retrieved. The query is executed in forward-only mode (QSqlQuery::setForwardOnly()).
+
+  It is created by DQQuery::iterate().
+
+Example code:
+\code
+
+    DQQuery<HealthCheck> query;
+
+    // C++11 range-based for
+    for (const HealthCheck &record : query.iterate()) {
+        qDebug() << record.name;
+    }
+
+    // Iterator style
+    DQCursor<HealthCheck> cursor = query.iterate();
+    for (DQCursor<HealthCheck>::iterator iter = cursor.begin() ; iter != cursor.end() ; ++iter) {
+        qDebug() << iter->name;
+    }
+
+\endcode
+
+  @remarks The model is reused for every record. Copy it if you need to keep the value after the iterator moved to next record.
+  @remarks The cursor could only be iterated once. prefetch() is ignored but selectRelated() is supported.
+ */
+
+template <typename T>
+class DQCursor {
+public:
+
+    /// Input iterator of DQCursor
+    class iterator {
+    public:
+        /// Construct an end iterator
+        iterator() : m_cursor(0) {
+        }
+
+        /// Construct an iterator positioned on current record of the cursor
+        explicit iterator(DQCursor *cursor) : m_cursor(cursor) {
+        }
+
+        /// Returns the current record
+        const T& operator*() const {
+            return m_cursor->m_model;
+        }
+
+        /// Access the current record
+        const T* operator->() const {
+            return &m_cursor->m_model;
+        }
+
+        /// Move to next record. It will become the end iterator if no more record.
+        iterator& operator++() {
+            if (m_cursor && !m_cursor->fetch())
+                m_cursor = 0;
+            return *this;
+        }
+
+        bool operator==(const iterator& rhs) const {
+            return m_cursor == rhs.m_cursor;
+        }
+
+        bool operator!=(const iterator& rhs) const {
+            return m_cursor != rhs.m_cursor;
+        }
+
+    private:
+        DQCursor *m_cursor;
+    };
+
+    /// Construct a cursor for the query
+    explicit DQCursor(const DQSharedQuery& query) : m_query(query) , m_started(false) , m_active(false) {
+    }
+
+    /// Construct a cursor with the same query as other cursor. It is not started yet.
+    DQCursor(const DQCursor& rhs) : m_query(rhs.m_query) , m_started(false) , m_active(false) {
+    }
+
+    /// Destructor. The result set is released.
+    ~DQCursor() {
+        if (m_active)
+            m_query.finish();
+    }
+
+    /// Execute the query and return the iterator of first record
+    /**
+      It could only be called once. The end iterator will be returned for any further call.
+     */
+    iterator begin() {
+        if (m_started)
+            return iterator();
+
+        m_started = true;
+
+        if (!m_query.exec(true))
+            return iterator();
+
+        m_active = true;
+
+        if (!fetch())
+            return iterator();
+
+        return iterator(this);
+    }
+
+    /// Returns the end iterator
+    iterator end() {
+        return iterator();
+    }
+
+private:
+    DQCursor& operator=(const DQCursor& rhs);
+
+    /// Read the next record to the model
+    bool fetch() {
+        if (!m_active)
+            return false;
+
+        if (!m_query.next() || !m_query.recordTo(&m_model)) {
+            m_query.finish();
+            m_active = false;
+            return false;
+        }
+
+        return true;
+    }
+
+    DQSharedQuery m_query;
+
+    /// The model reused by every record
+    T m_model;
+
+    bool m_started;
+
+    /// TRUE if the result set is not released yet
+    bool m_active;
+};
+
+#endif // DQCURSOR_H
@@ -2,21 +2,111 @@
 #include <QSharedData>
 #include "dqexpression.h"
 #include "dqwhere_p.h"
+#include "dqqueryrules.h"
+#include "dqsql.h"
+#include "dqsqlstatement.h"
+
+/// The max. no. of values in a list to be bound as placeholders
+#define DQ_VALUE_TABLE_THRESHOLD 256
+
+/* The id of a value table is held by a single expression (and its copies) until it is
+   destroyed. So two live queries never share a table. The released ids are reused , and
+   the no. of temporary tables is bounded by the max. no. of live expressions.
+ */
+static QMutex m_valueTableMutex;
+static QList<int> m_freeValueTables;
+static int m_valueTableCount = 0;
+
+/// The ids of value tables held by an expression
+class DQValueTableIds {
+public:
+    ~DQValueTableIds() {
+        QMutexLocker locker(&m_valueTableMutex);
+        m_freeValueTables << ids;
+    }
+
+    /// Take a free id
+    int acquire() {
+        QMutexLocker locker(&m_valueTableMutex);
+        int id = m_freeValueTables.isEmpty() ? m_valueTableCount++ : m_freeValueTables.takeLast();
+        ids << id;
+        return id;
+    }
+
+    QList<int> ids;
+};
 
 class DQExpressionPriv : public QSharedData {
 public:
-    /// The string expression
+    DQExpressionPriv() : m_null(true) , m_isOperand(false) , m_collected(false) , m_rendered(false) , m_tableIndex(0) {
+    }
+
+    /// The source of expression
+    DQWhere m_where;
+
+    /// The source of expression if it is a single operand
+    QVariant m_operand;
+
+    /// The string expression. It is rendered on demand.
     QString m_string;
 
-    QMap<QString,QVariant> m_values;
+    /// The structure of expression without any value
+    QString m_key;
+
+    /// The values in the order of placeholder
+    QVector<QVariant> m_values;
+
+    /// DQParam name to the positions of placeholder
+    QMap<QString,QList<int> > m_params;
+
+    /// Table name to values of large list
+    QMap<QString,QList<QVariant> > m_tables;
+
+    /// Table names in the order of appearance
+    QStringList m_tableNames;
 
-    int m_num;
+    /// The prefix of table name
+    QString m_tablePrefix;
+
+    /// The ids of tables. It is shared by the copies of expression.
+    QSharedPointer<DQValueTableIds> m_tableIds;
 
     bool m_null;
 
-    void process(DQWhere& where);
+    bool m_isOperand;
+
+    /// TRUE if the key , values and tables are collected
+    bool m_collected;
+
+    /// TRUE if the string is rendered
+    bool m_rendered;
+
+    /// The next table in m_tableNames to be rendered
+    int m_tableIndex;
+
+    /// The copies of expression share the processed result , and they may live in different threads
+    QMutex m_mutex;
+
+    /// Collect the key , values and tables once. The mutex should be locked.
+    void collect();
+
+    /// Render the string once. The mutex should be locked.
+    void render();
 
-    /// A recusrive verison of process()
+    /// A recursive version of collect(). It walks the tree without formatting any string.
+    void _collect(DQWhere& where);
+
+    void _collect(QVariant v);
+
+    void _collect(DQWhereDataPriv& data);
+
+    /// Append a token and a separator to the key
+    void appendKey(const QString& token);
+
+    /// Bind the values
+    void bind(QVariant v);
+
+    /// A recusrive verison of render(). It walks the tree in the same order as collect().
     QString _process(DQWhere& where);
 
     /// A recursive function to prcess the operand in DQWhere
@@ -24,8 +114,8 @@ public:
 
     QString _process(DQWhereDataPriv& data);
 
-    /// Bind the values , and return its argument name
-    QString bind(QVariant v);
+    /// Process a subquery. Its filter is rendered within this expression.
+    QString subselect(DQSharedQuery query);
 };
 
 
@@ -33,17 +123,39 @@ static int typeId = qMetaTypeId<DQWhere>();
 
 static int dataPrivTypeId = qMetaTypeId<DQWhereDataPriv>();
 
+static int paramTypeId = qMetaTypeId<DQParam>();
+
+/// The separator of tokens in key()
+static const QChar keySeparator(0x1f);
+
 DQExpression::DQExpression(){
     d = new DQExpressionPriv();
-
-    d->m_null = true;
+    d->m_tablePrefix = "dq_in_";
 }
 
 DQExpression::DQExpression(DQWhere where)
 {
     d = new DQExpressionPriv();
+    d->m_tablePrefix = "dq_in_";
+
+    d->m_where = where;
+    d->m_null = false;
+}
+
+DQExpression::DQExpression(DQWhere where,QString valueTablePrefix){
+    d = new DQExpressionPriv();
+    d->m_tablePrefix = valueTablePrefix;
+
+    d->m_where = where;
+    d->m_null = false;
+}
+
+DQExpression::DQExpression(QVariant operand){
+    d = new DQExpressionPriv();
+    d->m_tablePrefix = "dq_in_";
 
-    d->process(where);
+    d->m_operand = operand;
+    d->m_isOperand = true;
     d->m_null = false;
 }
 
@@ -65,27 +177,188 @@ bool DQExpression::isNull(){
 
 
 QString DQExpression::string(){
+    QMutexLocker locker(&d->m_mutex);
+    d->render();
     return d->m_string;
 }
 
-QMap<QString,QVariant> DQExpression::bindValues(){
+QString DQExpression::key(){
+    QMutexLocker locker(&d->m_mutex);
+    d->collect();
+    return d->m_key;
+}
+
+QVector<QVariant> DQExpression::bindValues(){
+    QMutexLocker locker(&d->m_mutex);
+    d->collect();
     return d->m_values;
 }
 
-void DQExpressionPriv::process(DQWhere& where){
-    m_string.clear();
-    m_values.clear();
+QMap<QString,QList<int> > DQExpression::params(){
+    QMutexLocker locker(&d->m_mutex);
+    d->collect();
+    return d->m_params;
+}
+
+QMap<QString,QList<QVariant> > DQExpression::valueTables(){
+    QMutexLocker locker(&d->m_mutex);
+    d->collect();
+    return d->m_tables;
+}
 
-    m_num = 0;
+int DQExpression::valueTableThreshold(){
+    return DQ_VALUE_TABLE_THRESHOLD;
+}
 
-    if (!where.isNull())
-        m_string = _process(where);
+void DQExpressionPriv::collect(){
+    if (m_collected || m_null)
+        return;
+    m_collected = true;
+
+    if (m_isOperand)
+        _collect(m_operand);
+    else if (!m_where.isNull())
+        _collect(m_where);
+}
+
+void DQExpressionPriv::render(){
+    if (m_rendered || m_null)
+        return;
+    m_rendered = true;
+
+    // The names of value tables are assigned by collect()
+    collect();
+    m_tableIndex = 0;
+
+    if (m_isOperand)
+        m_string = _process(m_operand);
+    else if (!m_where.isNull())
+        m_string = _process(m_where);
+}
+
+void DQExpressionPriv::appendKey(const QString& token){
+    m_key.append(token);
+    m_key.append(keySeparator);
+}
+
+void DQExpressionPriv::_collect(DQWhere& where){
+    if (where.isField()) {
+        appendKey(where.toString());
+        return;
+    }
+
+    m_key.append(QChar('('));
+
+    if (where.left().isValid())
+        _collect(where.left());
+
+    appendKey(where.op());
+    _collect(where.right());
+
+    m_key.append(QChar(')'));
+}
+
+void DQExpressionPriv::_collect(QVariant v){
+    if (v.userType() == typeId) {
+        DQWhere w = v.value<DQWhere>();
+        _collect(w);
+    } else if (v.userType() == dataPrivTypeId) {
+        DQWhereDataPriv data = v.value<DQWhereDataPriv>();
+        _collect(data);
+    } else {
+        bind(v);
+        m_key.append(QChar('?'));
+    }
+}
+
+void DQExpressionPriv::_collect(DQWhereDataPriv& data){
+    QList<QVariant> list;
+    list = data.list();
+
+    QVariant v;
+    QString name;
+    DQQueryRules rules;
+    DQWhere where,having;
+
+    switch (data.type() ) {
+    case DQWhereDataPriv::Between:
+        Q_ASSERT(list.size() == 2);
+        bind(list.at(0));
+        bind(list.at(1));
+        m_key.append(QChar('b'));
+        break;
+
+    case DQWhereDataPriv::In:
+        if (list.size() > DQ_VALUE_TABLE_THRESHOLD) {
+            if (m_tableIds.isNull())
+                m_tableIds = QSharedPointer<DQValueTableIds>(new DQValueTableIds());
+            name = m_tablePrefix + QString::number(m_tableIds->acquire());
+            m_tables[name] = list;
+            m_tableNames << name;
+            m_key.append(QChar('t'));
+            appendKey(name);
+            break;
+        }
+
+        foreach (v,list) {
+            bind(v);
+        }
+        m_key.append(QChar('i'));
+        appendKey(QString::number(list.size()));
+        break;
+
+    case DQWhereDataPriv::Subquery:
+        Q_ASSERT(list.size() == 1);
+        rules = list.at(0).value<DQSharedQuery>();
+        where = rules.where();
+        having = rules.having();
+
+        // Everything written by DQSqlStatement::subselect()
+        m_key.append(QChar('s'));
+        appendKey(rules.metaInfo() ? rules.metaInfo()->name() : QString());
+        appendKey(rules.func());
+        appendKey(rules.fields().join(","));
+        appendKey(rules.selectRelated().join(","));
+        appendKey(rules.groupBy().join(","));
+        appendKey(rules.orderBy().join(","));
+        appendKey(QString::number(rules.limit()));
+        appendKey(QString::number(rules.offset()));
+
+        if (!where.isNull()) {
+            m_key.append(QChar('w'));
+            _collect(where);
+        }
+        if (!having.isNull() && !rules.groupBy().isEmpty()) {
+            m_key.append(QChar('h'));
+            _collect(having);
+        }
+        m_key.append(QChar(')'));
+        break;
+
+    default:
+        break;
+    }
+}
+
+void DQExpressionPriv::bind(QVariant v){
+    if (v.userType() == paramTypeId) {
+        // The value is assigned on execution
+        m_params[v.value<DQParam>().name()] << m_values.size();
+        v = QVariant();
+    }
+
+    m_values.append(v);
 }
 
 QString DQExpressionPriv::_process(DQWhere& where) {
     if (where.isField())
         return where.toString();
 
+    if (!where.left().isValid()) {
+        // exists() does not have left operand
+        return QString("%1 %2").arg(where.op()).arg(_process(where.right()));
+    }
+
     QString leftString,rightString;
 
     leftString = _process(where.left());
@@ -109,10 +382,7 @@ QString DQExpressionPriv::_process(QVariant v) {
         DQWhereDataPriv data = v.value<DQWhereDataPriv>();
         res = _process(data);
     } else {
-        res = bind(v);
-//        QString arg = QString(":arg%1").arg(m_num++);
-//        m_values[arg] = v;
-//        res = arg;
+        res = "?";
     }
 
     return res;
@@ -120,29 +390,34 @@ QString DQExpressionPriv::_process(QVariant v) {
 
 QString DQExpressionPriv::_process(DQWhereDataPriv& data){
     QString res;
-    QString arg,arg1,arg2;
     QStringList args;
     QList<QVariant> list;
     list = data.list();
 
-    QVariant v;
-
     switch (data.type() ) {
     case DQWhereDataPriv::Between:
         Q_ASSERT(list.size() == 2);
-        arg1 = bind(list.at(0));
-        arg2 = bind(list.at(1));
-        res = QString("%1 and %2").arg(arg1).arg(arg2);
+        res = "? and ?";
         break;
 
     case DQWhereDataPriv::In:
-        foreach (v,list) {
-            arg = bind(v);
-            args << arg;
+        if (list.size() > DQ_VALUE_TABLE_THRESHOLD) {
+            // The size of statement is fixed no matter how long the list is
+            res = QString("(SELECT v FROM %1)").arg(m_tableNames.at(m_tableIndex++));
+            break;
+        }
+
+        for (int i = 0 ; i < list.size() ; i++) {
+            args << "?";
         }
         res = QString("(%1)").arg(args.join(","));
         break;
 
+    case DQWhereDataPriv::Subquery:
+        Q_ASSERT(list.size() == 1);
+        res = QString("(%1)").arg(subselect(list.at(0).value<DQSharedQuery>()));
+        break;
+
     default:
         qWarning() << "DQWhereDataPriv - Unsupported type";
         break;
@@ -151,8 +426,26 @@ QString DQExpressionPriv::_process(DQWhereDataPriv& data){
     return res;
 }
 
-QString DQExpressionPriv::bind(QVariant v){
-    QString arg = QString(":arg%1").arg(m_num++);
-    m_values[arg] = v;
-    return arg;
+QString DQExpressionPriv::subselect(DQSharedQuery query){
+    DQQueryRules rules;
+    rules = query;
+
+    DQWhere where = rules.where();
+    DQWhere having = rules.having();
+    QString filter,havingFilter;
+
+    // The values of subquery are placed in between the values of outer expression
+    if (!where.isNull())
+        filter = _process(where);
+    // HAVING is only written with GROUP BY
+    if (!having.isNull() && !rules.groupBy().isEmpty())
+        havingFilter = _process(having);
+
+    DQSqlStatement *statement = rules.connection().sql().statement();
+    if (!statement) {
+        qWarning() << "DQExpression - The connection of subquery is not opened";
+        return QString();
+    }
+
+    return statement->subselect(rules,filter,havingFilter);
 }
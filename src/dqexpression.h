@@ -3,7 +3,8 @@
 
 #include <dqwhere.h>
 #include <QMap>
-#include <QSharedDataPointer>
+#include <QVector>
+#include <QExplicitlySharedDataPointer>
 
 class DQExpressionPriv;
 
@@ -17,21 +18,67 @@ public:
     DQExpression();
     DQExpression(const DQExpression& rhs);
     DQExpression(DQWhere where);
+
+    /// Construct an expression with the name prefix of the temporary tables of valueTables()
+    /**
+      The prefix should be unique among the expressions of a statement.
+     */
+    DQExpression(DQWhere where,QString valueTablePrefix);
+
+    /// Construct an expression of a single operand
+    /**
+      @param operand A value or a DQWhere object
+     */
+    DQExpression(QVariant operand);
     DQExpression &operator=(const DQExpression &rhs);
 
     ~DQExpression();
 
     /// Get the expression in string
+    /**
+      The string is rendered on the first call , and shared by the copies of expression.
+     */
     QString string();
 
-    /// A map of values to find with QSqlQuery
-    QMap<QString,QVariant> bindValues();
+    /// The structure of expression without any value
+    /**
+      Two expressions with the same key are rendered into the same string() , so it could be
+      used to look up a cached statement without rendering. The key is built on the first call
+      together with bindValues() , params() and valueTables().
+     */
+    QString key();
+
+    /// The values to bind with QSqlQuery
+    /**
+      The values are bound by position. The n-th value is for the n-th "?" placeholder
+      in string(). The placeholder of DQParam is included with a null value.
+     */
+    QVector<QVariant> bindValues();
+
+    /// A map of DQParam name to the positions of its placeholders in bindValues()
+    QMap<QString,QList<int> > params();
+
+    /// The values of large in() / notIn() list keyed by the name of temporary table
+    /**
+      A list with more values than valueTableThreshold() is not bound as placeholders.
+      It is written as "(SELECT v FROM name)" , and the values should be filled to the
+      temporary table before execution.
+
+      The name is held by this expression and its copies until they are destroyed , so
+      the tables of two live expressions never collide. The name is reused after that.
+
+      @see DQSql::setValueTable()
+     */
+    QMap<QString,QList<QVariant> > valueTables();
+
+    /// The max. no. of values in in() / notIn() list that are bound as placeholders
+    static int valueTableThreshold();
 
     bool isNull();
 
 private:
 
-    QSharedDataPointer<DQExpressionPriv> d;
+    QExplicitlySharedDataPointer<DQExpressionPriv> d;
 };
 
 #endif // DQEXPRESSION_H
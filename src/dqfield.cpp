@@ -71,10 +71,11 @@ static QString unescape(QString value) {
 
 template <>
 bool DQField<QStringList>::set(QVariant value){
-    QString str;
-
-    if (value.type() == QVariant::String) {
-        str = value.toString();
+    if (value.isNull()) {
+        m_value.clear();
+        m_null = true;
+    } else if (value.type() == QVariant::String) {
+        QString str = value.toString();
         QStringList list = str.split(SEP);
         QStringList result;
 
@@ -82,32 +83,33 @@ bool DQField<QStringList>::set(QVariant value){
             result << unescape(str);
         }
 
-        value = result;
+        m_value = result;
+        m_null = false;
+    } else {
+        m_value = value.toStringList();
+        m_null = false;
     }
 
-//    qDebug() << __func__ << str;
-    return DQBaseField::set(value);;
+    setModified(true);
+    return true;
 }
 
 template <>
 QVariant DQField<QStringList>::get(bool convert) const {
-    QVariant val = DQBaseField::get(convert);
+    if (m_null)
+        return QVariant();
 
-    if (convert && val.type() == QVariant::StringList ) {
-        QStringList list = val.toStringList();
+    if (convert) {
         QStringList result;
-        QString str;
 
-        foreach (str,list) {
+        foreach (QString str,m_value) {
             result << escape(str);
         }
 
-        str = result.join(SEP);
-        val = str;
+        return result.join(SEP);
     }
-//    qDebug() << __func__ << str << list;
 
-    return val;
+    return m_value;
 }
 
 
@@ -5,9 +5,12 @@
 
 /// Database field
 /**
-    DQField store the value of a field in database model. The format is QVariant.
-    Therefore you may assign a QVariant to DQField direclty, and you may access
-    the stored QVariant by using operator-> or get() function.
+    DQField store the value of a field in database model. The value is stored in
+    its native type T together with a null flag. You may assign a QVariant to DQField direclty,
+    and you may access the value as QVariant by using operator-> or get() function.
+
+    The typed accessors (value() , setValue() , isNull() and the cast operator to T) do not
+    involve QVariant. The conversion from / to QVariant only happens on database access.
 
     @see DQModel
     @see DQForeignKey
@@ -18,7 +21,7 @@ class DQField : public DQBaseField
 {
 public:
     /// Default constructor
-    DQField(){
+    DQField() : m_null(true) , m_value() {
     }
 
     /// Return the type id of the field
@@ -34,7 +37,7 @@ public:
 
     /// Compare with other DQField
     inline bool operator==(const DQField& rhs) const {
-        return get() == rhs.get();
+        return m_null == rhs.m_null && (m_null || m_value == rhs.m_value);
     }
 
     /// Compare with QVariant type
@@ -49,12 +52,12 @@ public:
 
     /// Compare with its template type
     inline bool operator==(const T& t) const {
-        return get() == t;
+        return !m_null && m_value == t;
     }
 
     /// Compare with its template type
     inline bool operator!=(const T& t) const {
-        return get() != t;
+        return !operator==(t);
     }
 
     /// Compare with string type
@@ -69,20 +72,55 @@ public:
 
     /// Get the value of the field
     inline QVariant get(bool convert = false) const {
-        return DQBaseField::get(convert);
+        Q_UNUSED(convert);
+        if (m_null)
+            return QVariant();
+        return qVariantFromValue(m_value);
     }
 
     /// Set the value of the field
+    /**
+      The value is converted to T by QVariant::value(). A null QVariant set the field to null.
+     */
     inline bool set(QVariant value) {
-        return DQBaseField::set(value);
+        if (value.isNull()) {
+            m_value = T();
+            m_null = true;
+        } else {
+            m_value = value.value<T>();
+            m_null = false;
+        }
+        setModified(true);
+        return true;
+    }
+
+    /// Get the value of the field in native type. A default constructed value is returned if it is null.
+    inline const T& value() const {
+        return m_value;
+    }
+
+    /// Set the value of the field in native type
+    inline void setValue(const T& t) {
+        m_value = t;
+        m_null = false;
+        setModified(true);
+    }
+
+    /// Return TRUE if the field is null
+    inline bool isNull() const {
+        return m_null;
     }
 
     /// Cast it to the template type
     inline operator T() const {
-        QVariant v = get();
-        return v.value<T>();
+        return m_value;
     }
 
+protected:
+    /// It is placed before m_value to fill the padding after DQBaseField
+    bool m_null;
+
+    T m_value;
 };
 
 template <>
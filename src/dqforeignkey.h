@@ -81,27 +81,20 @@ template <typename T>
 class DQForeignKey : public DQField<int> {
 public:
     /// Construct a foreign key field
-    DQForeignKey() : model(0){
+    DQForeignKey() {
     }
 
     /// Destruct the foreign key field
     ~DQForeignKey() {
-        if (model)
-            delete model;
     }
 
-    /// Copy from other DQForeignKey object.
-    /** It will copy the contained model from other
-      DQForeignKey object. The original model
-      will destroyed.
+    /// Copy from a model
+    /** It will copy the model and link to it. The original model
+      will be released.
      */
     DQForeignKey& operator=(T& rhs) {
         set(rhs.id());
-        if (model){
-            delete model;
-            model = 0;
-        }
-        model = new T(rhs);
+        model = QSharedPointer<T>(new T(rhs));
 
         return *this;
     }
@@ -116,23 +109,35 @@ public:
     /// Access the data field of the "linked" model
     T* operator->() {
         if (!model)
-            model = new T();
+            model = QSharedPointer<T>(new T());
         if ( !get().isNull() &&  !isLoaded()  ) {
             load();
         }
-        return model;
+        return model.data();
     }
 
     /// Return an instance of the "linked" model
     T& operator() () {
         if (!model)
-            model = new T();
+            model = QSharedPointer<T>(new T());
         if ( !get().isNull() &&  !isLoaded() ) {
             load();
         }
         return *model;
     }
 
+    /// Set the "linked" model without loading from database
+    /**
+      The model is shared with the caller. It is used by DQQuery::prefetch() to share
+      the same instance between records that link to the same id.
+     */
+    virtual bool setLinkedModel(QSharedPointer<DQAbstractModel> value) {
+        if (!value.isNull() && value->metaInfo() != dqMetaInfo<T>())
+            return false;
+        model = qSharedPointerCast<T>(value);
+        return true;
+    }
+
     static DQClause clause() {
         QVariant v = qVariantFromValue( (void*) dqMetaInfo<T>());
         return DQClause(DQClause::FOREIGN_KEY , v );
@@ -153,7 +158,7 @@ public:
 
 private:
     bool load();
-    T *model;
+    QSharedPointer<T> model;
 
 };
 
@@ -166,6 +171,8 @@ bool DQForeignKey<T>::load() {
             query.recordTo(*model);
             res = true;
         }
+        // Release the cached statement
+        query.finish();
     }
 
     return res;
@@ -6,6 +6,7 @@
 #include "dqlist.h"
 
 #include "dqsql.h"
+#include "dqasync.h"
 
 //#define TABLE_NAME "Model without DQ_MODEL"
 #define TABLE_NAME ""
@@ -46,6 +47,35 @@ bool DQModel::save(bool forceInsert,bool forceAllField) {
     Q_ASSERT(info);
 
     QStringList fields = info->fieldNameList();
+    DQSql sql = m_connection.sql();
+    bool res ;
+
+    if (!forceInsert && !id.get().isNull() && !id.isModified()) {
+        // An existing record. Only update the modified fields
+        QStringList modifiedFields;
+        foreach (QString field , fields) {
+            if (field == "id")
+                continue;
+            if (forceAllField || info->field(this,field)->isModified())
+                modifiedFields << field;
+        }
+
+        if (modifiedFields.isEmpty()) // Nothing changed
+            return true;
+
+        int rows = sql.update(info,this,modifiedFields);
+        m_connection.setLastQuery(sql.lastQuery());
+
+        if (rows > 0) {
+            info->setModified(this,false);
+            return true;
+        } else if (rows < 0) {
+            return false;
+        }
+
+        // The record is not existed anymore. Insert it again.
+    }
+
     QStringList nonNullFields;
     if (forceAllField) {
 
@@ -66,21 +96,49 @@ bool DQModel::save(bool forceInsert,bool forceAllField) {
 
     }
 
-    bool res ;
-
-    DQSql sql = m_connection.sql();
-
-    if (forceInsert || id->isNull() ) {
+    if (forceInsert || id.get().isNull() ) {
         res = sql.replaceInto(info,this,nonNullFields,true);
     } else {
         res = sql.replaceInto(info,this,nonNullFields,false);
     }
 
+    if (res)
+        info->setModified(this,false);
+
     m_connection.setLastQuery(sql.lastQuery());
 
     return res;
 }
 
+/// Save a model on the worker thread
+class DQAsyncSaveTask : public DQAsyncResultTask<bool> {
+public:
+    DQAsyncSaveTask(DQModel *model,bool forceInsert,bool forceAllField) :
+        m_model(model) , m_forceInsert(forceInsert) , m_forceAllField(forceAllField) {
+    }
+
+protected:
+    bool exec(DQConnection connection) {
+        DQConnection source = m_model->connection();
+        m_model->setConnection(connection);
+        bool res = m_model->save(m_forceInsert,m_forceAllField);
+        m_model->setConnection(source);
+        return res;
+    }
+
+private:
+    DQModel *m_model;
+    bool m_forceInsert;
+    bool m_forceAllField;
+};
+
+QFuture<bool> DQModel::saveAsync(bool forceInsert,bool forceAllField){
+    DQAsyncSaveTask *task = new DQAsyncSaveTask(this,forceInsert,forceAllField);
+    QFuture<bool> future = task->future();
+    m_connection.runAsync(task);
+    return future;
+}
+
 bool DQModel::load(DQWhere where){
     bool res = false;
 
@@ -91,10 +149,11 @@ bool DQModel::load(DQWhere where){
         if (query.next()){
             res = query.recordTo(this);
         }
+        query.finish();
     }
 
     if (!res)
-        id->clear();
+        id.clear();
 
     m_connection.setLastQuery(query.lastQuery());
 
@@ -102,7 +161,7 @@ bool DQModel::load(DQWhere where){
 }
 
 bool DQModel::remove() {
-    if (id->isNull())
+    if (id.get().isNull())
         return false;
 
     _DQMetaInfoQuery query( metaInfo() ,  m_connection);
@@ -111,7 +170,7 @@ bool DQModel::remove() {
 
     bool res = query.remove();
     if (res){
-        id->clear();
+        id.clear();
     }
 
     m_connection.setLastQuery( query.lastQuery());
@@ -9,6 +9,7 @@
 #include <QObject>
 #include <QVariant>
 #include <QStringList>
+#include <QFuture>
 #include <dqfield.h>
 #include <dqconnection.h>
 #include <dqwhere.h>
@@ -82,9 +83,26 @@ public:
       If the id is not set , the record will be inserted to the database , then id field will be updated automatically.
       The successive call will update the record instead of insert unless forceInsert is TRUE.
 
+      For a record that is loaded or saved before , only the modified fields (DQBaseField::isModified())
+      will be written by an "UPDATE" statement. If nothing is changed, no statement will be executed.
+      If the id is changed or the record is not found in database, it will be written by "REPLACE".
+
      */
     virtual bool save(bool forceInsert = false,bool forceAllField = false);
 
+    /// Save the record on the worker thread of the connection
+    /**
+      It is the asynchronous version of save(). The operation is queued by DQConnection::runAsync()
+      and the result is returned by the future.
+
+      The record is saved by a cloned database. It is not a part of any DQTransaction
+      on the connection , and it could not be saved to an in-memory database.
+
+      @remarks The model must not be accessed or destroyed until the future is finished.
+      @see DQConnection::runAsync()
+     */
+    QFuture<bool> saveAsync(bool forceInsert = false,bool forceAllField = false);
+
     /// Load the record that first match with filter
     bool load(DQWhere where);
 
@@ -145,12 +163,7 @@ public:
     /// Return the fields of DQModel
     static inline QList<DQModelMetaInfoField> fields() {
         QList<DQModelMetaInfoField> result;
-        DQModel m;
-        result << DQModelMetaInfoField("id",
-                                       offsetof(DQModel,id),
-                                       m.id.type(),
-                                       m.id.clause()
-                                       );
+        result << _dqMetaInfoField("id",offsetof(DQModel,id),&DQModel::id);
         return result;
     }
 };
@@ -167,7 +180,7 @@ public:
   @see DQDefault
  */
 #define DQ_FIELD(field , CLAUSE...) \
-new DQModelMetaInfoField(#field,offsetof(Table,field),m.field.type(), m.field.clause(), ## CLAUSE)
+_dqMetaInfoField(#field,offsetof(Table,field),&Table::field, ## CLAUSE)
 
 /**
   See tests/modes/model1.h
@@ -182,8 +195,7 @@ new DQModelMetaInfoField(#field,offsetof(Table,field),m.field.type(), m.field.cl
                 return #MODEL; \
             } \
             static inline QList<DQModelMetaInfoField> fields() {\
-                QList<DQModelMetaInfoField> result;\
-                MODEL m;
+                QList<DQModelMetaInfoField> result;
 
 #define DQ_DECLARE_MODEL_END(MODEL,NAME) \
                 return result; \
@@ -248,16 +260,16 @@ DQ_DECLARE_MODEL(User,
 #define DQ_DECLARE_MODEL(MODEL,NAME,FIELDS...) \
         DQ_DECLARE_MODEL_BEGIN(MODEL,NAME) \
             result << DQModelMetaInfoHelper<DQModel>::fields(); \
-            DQModelMetaInfoField* list[] = { FIELDS,0 }; \
-            result << _dqMetaInfoCreateFields(list) ; \
+            const DQModelMetaInfoField list[] = { FIELDS }; \
+            _dqMetaInfoAppendFields(result,list); \
         DQ_DECLARE_MODEL_END(MODEL,NAME)
 
 /// Declare a model which is not a direct sub-class of DQModel
 #define DQ_DECLARE_MODEL2(MODEL,NAME,PARENT,FIELDS...) \
         DQ_DECLARE_MODEL_BEGIN(MODEL,NAME) \
             result << DQModelMetaInfoHelper<PARENT>::fields(); \
-            DQModelMetaInfoField* list[] = { FIELDS,0 }; \
-            result << _dqMetaInfoCreateFields(list) ; \
+            const DQModelMetaInfoField list[] = { FIELDS }; \
+            _dqMetaInfoAppendFields(result,list); \
         DQ_DECLARE_MODEL_END(MODEL,NAME)
 
 /// The DQ_MODEL macro must appear in the class definition that declares model's virtual function for database access
@@ -24,6 +24,8 @@ void dqRegisterMetaInfo(QString name, DQModelMetaInfo *metaType){
 DQModelMetaInfo::DQModelMetaInfo() : QObject() {
     QCoreApplication *app = QCoreApplication::instance();
     setParent(app); // Then it will be destroyed in program termination. Make valgrind happy.
+    placementCreateFunc = 0;
+    m_objectSize = 0;
 }
 
 void DQModelMetaInfo::registerField(DQModelMetaInfoField field){
@@ -34,7 +36,9 @@ void DQModelMetaInfo::registerField(DQModelMetaInfoField field){
     }
 
     m_fields[field.name] = field;
+    m_fieldIndex[field.name] = m_fieldList.size();
     m_fieldList << field;
+    m_fieldNameList = m_fields.keys();
 }
 
 void DQModelMetaInfo::registerFields(QList<DQModelMetaInfoField> fields){
@@ -44,19 +48,24 @@ void DQModelMetaInfo::registerFields(QList<DQModelMetaInfoField> fields){
 }
 
 QStringList DQModelMetaInfo::fieldNameList(){
-    QStringList result;
-    QMapIterator<QString, DQModelMetaInfoField> iter(m_fields);
-    while (iter.hasNext()) {
-         iter.next();
-         result << iter.key();
-    }
-    return result;
+    return m_fieldNameList;
 }
 
 QList<DQModelMetaInfoField> DQModelMetaInfo::foreignKeyList(){
     return m_foreignKeyList;
 }
 
+DQModelMetaInfo* DQModelMetaInfo::foreignKeyMetaInfo(QString field){
+    foreach (DQModelMetaInfoField f , m_foreignKeyList){
+        if (f.name == field) {
+            QVariant v = f.clause.flag(DQClause::FOREIGN_KEY);
+            return (DQModelMetaInfo*) v.value<void *>();
+        }
+    }
+
+    return 0;
+}
+
 QStringList DQModelMetaInfo::foreignKeyNameList(){
     QStringList result;
     foreach (DQModelMetaInfoField field , m_foreignKeyList){
@@ -75,48 +84,64 @@ const DQModelMetaInfoField* DQModelMetaInfo::at(int idx) const{
     return &m_fieldList.at(idx);
 }
 
-bool DQModelMetaInfo::setValue(DQAbstractModel *model,QString field, const QVariant& val){
-    if (!m_fields.contains(field))
-        return false;
-    int offset = m_fields[field].offset;
+int DQModelMetaInfo::indexOf(QString field) const{
+    return m_fieldIndex.value(field,-1);
+}
 
-    DQBaseField* f = DQ_MODEL_GET_FIELD(model,offset);
-    f->set(val);
-    return true;
+bool DQModelMetaInfo::setValue(DQAbstractModel *model,QString field, const QVariant& val){
+    return setValue(model,indexOf(field),val);
 }
 
 bool DQModelMetaInfo::setValue(DQAbstractModel *model,int index, const QVariant& val){
-    if (index< 0 || index > size() ) {
+    if (index < 0 || index >= size() ) {
         return false;
     }
 
-    int offset = m_fieldList[index].offset;
+    const DQModelMetaInfoField &field = m_fieldList.at(index);
 
-    DQBaseField* f = DQ_MODEL_GET_FIELD(model,offset);
-    f->set(val);
-    return true;
+    DQBaseField* f = DQ_MODEL_GET_FIELD(model,field.offset);
+    if (field.setFunc)
+        return field.setFunc(f,val);
+    return f->set(val);
 }
 
 QVariant DQModelMetaInfo::value(const DQAbstractModel *model,QString field,bool convert) const{
-    QVariant v;
-    if (!m_fields.contains(field))
-        return v;
-    int offset = m_fields[field].offset;
+    return value(model,indexOf(field),convert);
+}
 
-    DQBaseField* f = DQ_MODEL_GET_FIELD(model,offset);
+QVariant DQModelMetaInfo::value(const DQAbstractModel *model,int index ,bool convert) const{
+    if (index < 0 || index >= size() ) {
+        return QVariant();
+    }
+
+    const DQModelMetaInfoField &field = m_fieldList.at(index);
 
+    DQBaseField* f = DQ_MODEL_GET_FIELD(model,field.offset);
+    if (field.getFunc)
+        return field.getFunc(f,convert);
     return f->get(convert);
 }
 
-QVariant DQModelMetaInfo::value(const DQAbstractModel *model,int index ,bool convert) const{
-    if (index< 0 || index > size() ) {
-        return QVariant();
+DQBaseField* DQModelMetaInfo::field(DQAbstractModel *model,QString name) const{
+    return field(model,indexOf(name));
+}
+
+DQBaseField* DQModelMetaInfo::field(DQAbstractModel *model,int index) const{
+    if (index < 0 || index >= size() ) {
+        return 0;
     }
 
     int offset = m_fieldList[index].offset;
 
-    DQBaseField* f = DQ_MODEL_GET_FIELD(model,offset);
-    return f->get(convert);
+    return DQ_MODEL_GET_FIELD(model,offset);
+}
+
+void DQModelMetaInfo::setModified(DQAbstractModel *model,bool modified){
+    int n = m_fieldList.size();
+    for (int i = 0 ; i < n;i++) {
+        DQBaseField* f = DQ_MODEL_GET_FIELD(model,m_fieldList[i].offset);
+        f->setModified(modified);
+    }
 }
 
 QString DQModelMetaInfo::name() const{
@@ -139,6 +164,14 @@ DQAbstractModel* DQModelMetaInfo::create(){
     return createFunc();
 }
 
+DQAbstractModel* DQModelMetaInfo::create(void *buffer){
+    return placementCreateFunc(buffer);
+}
+
+int DQModelMetaInfo::objectSize() const{
+    return m_objectSize;
+}
+
 DQSharedList DQModelMetaInfo::initialData(){
     return initialDataFunc();
 }
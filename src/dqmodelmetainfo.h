@@ -6,7 +6,9 @@
 #include <QVariant>
 #include <QtCore>
 #include <dqclause.h>
+#include <dqbasefield.h>
 #include <QObject>
+#include <new>
 #include <dqabstractmodel.h>
 #include <dqsharedlist.h>
 
@@ -19,6 +21,8 @@ class DQModelMetaInfoField {
 public:
     inline DQModelMetaInfoField(){
         type = QVariant::Invalid;
+        getFunc = 0;
+        setFunc = 0;
     }
 
     inline DQModelMetaInfoField(QString name,
@@ -30,6 +34,8 @@ public:
         offset(offset),
         type(type) {
         clause = defaultClause | c;
+        getFunc = 0;
+        setFunc = 0;
     }
 
     /// The name of field
@@ -43,15 +49,52 @@ public:
     /// The clause of the field
     DQClause clause;
 
+    /// Read the field as QVariant without virtual function call. NULL if it is not bound.
+    _dqFieldGetFunc getFunc;
+
+    /// Write the field from QVariant without virtual function call. NULL if it is not bound.
+    _dqFieldSetFunc setFunc;
 };
 
+/// Create the meta info of a field from its member pointer
+/**
+  The type , default clause and the get / set binder are resolved from the type of
+  member pointer at compile time. No model instance is needed.
+ */
+template <typename M , typename F>
+inline DQModelMetaInfoField _dqMetaInfoField(QString name,
+                                             int offset,
+                                             F M::* member,
+                                             DQClause c = DQClause()) {
+    Q_UNUSED(member);
+    DQModelMetaInfoField res(name,offset,F::type(),F::clause(),c);
+    res.getFunc = _dqFieldGet<F>;
+    res.setFunc = _dqFieldSet<F>;
+    return res;
+}
+
+/// Append an array of fields created by DQ_FIELD
+template <int N>
+inline void _dqMetaInfoAppendFields(QList<DQModelMetaInfoField> &result, const DQModelMetaInfoField (&list)[N]) {
+    for (int i = 0 ; i < N;i++) {
+        result << list[i];
+    }
+}
+
 typedef DQAbstractModel* (*_dqAbstractModelCreateFunc)();
+typedef DQAbstractModel* (*_dqAbstractModelPlacementCreateFunc)(void*);
 /// A wrapper template for DQAbstractModel creation
 template <class T>
 DQAbstractModel* _dqAbstractModelCreate() {
     return new T();
 }
 
+/// A wrapper template for DQAbstractModel creation on preallocated memory
+template <class T>
+DQAbstractModel* _dqAbstractModelPlacementCreate(void *buffer) {
+    return new (buffer) T();
+}
+
 typedef DQSharedList (*_dqMetaInfoInitalDataFunc)();
 
 template <class T>
@@ -87,12 +130,24 @@ public:
     /// List of foreign key
     QList<DQModelMetaInfoField> foreignKeyList();
 
+    /// Get the meta info of the model referenced by a foreign key
+    /**
+      @return The meta info or NULL if the field is not a foreign key
+     */
+    DQModelMetaInfo* foreignKeyMetaInfo(QString field);
+
     /// No. of field
     int size() const;
 
     /// Get the field data at index
     const DQModelMetaInfoField* at(int idx) const;
 
+    /// Get the index of a field
+    /**
+      @return The index (registration order) of the field or -1 if it is not existed
+     */
+    int indexOf(QString field) const;
+
     /// Set value of a field on a model
     bool setValue(DQAbstractModel *model,QString field, const QVariant& val);
 
@@ -117,6 +172,18 @@ public:
      */
     QVariant value(const DQAbstractModel *model,int index ,bool convert = false) const;
 
+    /// Get the field object of a model
+    /**
+      @return The field or NULL if it is not existed
+     */
+    DQBaseField* field(DQAbstractModel *model,QString name) const;
+
+    /// Get the field object of a model at index
+    DQBaseField* field(DQAbstractModel *model,int index) const;
+
+    /// Set the modified flag of all the fields of a model
+    void setModified(DQAbstractModel *model,bool modified);
+
     /// The table name
     QString name() const;
 
@@ -129,6 +196,16 @@ public:
     /// Create an instance of the associated model type
     DQAbstractModel* create();
 
+    /// Construct an instance of the associated model type on preallocated memory
+    /**
+      @param buffer The memory with at least objectSize() bytes. It should be aligned for any type.
+      @remarks The instance must be destroyed by calling its destructor explicitly instead of "delete"
+     */
+    DQAbstractModel* create(void *buffer);
+
+    /// The size of an instance of the associated model type (sizeof)
+    int objectSize() const;
+
 protected:
     /// Default constructor
     DQModelMetaInfo();
@@ -152,6 +229,12 @@ private:
     /// Field in registration order
     QList<DQModelMetaInfoField> m_fieldList;
 
+    /// Field name to index of m_fieldList
+    QHash<QString,int> m_fieldIndex;
+
+    /// Cached result of fieldNameList()
+    QStringList m_fieldNameList;
+
     QList<DQModelMetaInfoField> m_foreignKeyList;
 
     /// The table name
@@ -159,6 +242,8 @@ private:
     QString m_className;
 
     _dqAbstractModelCreateFunc createFunc;
+    _dqAbstractModelPlacementCreateFunc placementCreateFunc;
+    int m_objectSize;
     _dqMetaInfoInitalDataFunc initialDataFunc;
 
     template <typename T>
@@ -233,6 +318,8 @@ inline DQModelMetaInfo* dqMetaInfo() {
         metaInfo->setName(name);
         metaInfo->setClassName(DQModelMetaInfoHelper<T>::className());
         metaInfo->createFunc = _dqAbstractModelCreate<T>;
+        metaInfo->placementCreateFunc = _dqAbstractModelPlacementCreate<T>;
+        metaInfo->m_objectSize = sizeof(T);
         metaInfo->initialDataFunc =_dqMetaInfoInitalData<T>;
 
         QList<DQModelMetaInfoField> fields = DQModelMetaInfoHelper<T>::fields();
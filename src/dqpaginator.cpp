@@ -0,0 +1,113 @@
+#include <QtCore>
+#include "dqpaginator.h"
+#include "dqqueryrules.h"
+
+DQSharedPaginator::DQSharedPaginator(const DQSharedQuery& query , int pageSize , QString orderField) :
+    m_query(query) ,
+    m_pageSize(qMax(pageSize,1)) ,
+    m_orderField(orderField)
+{
+    DQQueryRules rules;
+    rules = query;
+    m_where = rules.where();
+
+    reset();
+}
+
+int DQSharedPaginator::pageSize() const {
+    return m_pageSize;
+}
+
+QString DQSharedPaginator::orderField() const {
+    return m_orderField;
+}
+
+DQSharedList DQSharedPaginator::nextPage(){
+    DQSharedList res;
+    if (m_end)
+        return res;
+
+    DQSharedQuery query = pageQuery();
+    res = query.all();
+
+    if (res.size() < m_pageSize)
+        m_end = true;
+
+    if (res.size() > 0) {
+        DQQueryRules rules;
+        rules = m_query;
+        DQModelMetaInfo *metaInfo = rules.metaInfo();
+        DQAbstractModel *last = res.at(res.size() - 1);
+
+        m_lastKey = metaInfo->value(last,m_orderField);
+        m_lastId = metaInfo->value(last,"id");
+        m_pageCount++;
+    }
+
+    return res;
+}
+
+bool DQSharedPaginator::hasNext() const {
+    return !m_end;
+}
+
+int DQSharedPaginator::pageCount() const {
+    return m_pageCount;
+}
+
+QVariant DQSharedPaginator::lastKey() const {
+    return m_lastKey;
+}
+
+QVariant DQSharedPaginator::lastId() const {
+    return m_lastId;
+}
+
+void DQSharedPaginator::seek(QVariant key , QVariant id){
+    m_lastKey = key;
+    m_lastId = id;
+    m_end = false;
+}
+
+void DQSharedPaginator::reset(){
+    m_lastKey = QVariant();
+    m_lastId = QVariant();
+    m_pageCount = 0;
+    m_end = false;
+}
+
+DQSharedQuery DQSharedPaginator::pageQuery(){
+    DQWhere key(m_orderField);
+    DQWhere where;
+    QStringList terms;
+    terms << m_orderField;
+
+    if (m_orderField == "id") {
+        if (!m_lastKey.isNull())
+            where = key > m_lastKey;
+    } else {
+        terms << "id";
+        if (m_lastKey.isNull()) {
+            where = key.isNot(QVariant());
+        } else if (m_lastId.isNull()) {
+            where = key > m_lastKey;
+        } else {
+            // The range "key >= last_key" could be searched by the index of key. The
+            // equivalent "key > ? OR (key = ? AND id > ?)" is planned as a scan from the start.
+            where = (key >= m_lastKey) && ((key > m_lastKey) || (DQWhere("id") > m_lastId));
+        }
+    }
+
+    DQWhere filter = m_where;
+    if (!filter.isNull() && !where.isNull()) {
+        where = filter && where;
+    } else if (!filter.isNull()) {
+        where = filter;
+    }
+
+    DQSharedQuery query = m_query.orderBy(terms).limit(m_pageSize).offset(0);
+    if (!where.isNull())
+        query = query.filter(where);
+
+    return query;
+}
@@ -0,0 +1,124 @@
+#ifndef DQPAGINATOR_H
+#define DQPAGINATOR_H
+
+#include <dqsharedquery.h>
+#include <dqsharedlist.h>
+#include <dqlist.h>
+
+/// DQSharedPaginator is the base class of DQPaginator that reads the result of a query page by page with keyset pagination
+/**
+  Instead of skipping records by OFFSET , it remembers the sort key of the last record
+  and reads the next page by
+
+\code
+    WHERE filter AND key >= last_key AND (key > last_key OR id > last_id) ORDER BY key,id LIMIT n
+\endcode
+
+  The "id" is the tie-breaker for duplicated key. With an index on the key , SQLite searches
+  the range of key >= last_key , so the cost of a page does not depend on its position.
+
+  @remarks The records are sorted in ascending order. The records with NULL key are skipped.
+  @see DQPaginator
+ */
+
+class DQSharedPaginator {
+public:
+    /// Construct a paginator for the query
+    /**
+      @param query The query. Its filter is applied on every page. The orderBy() and limit() are replaced.
+      @param pageSize The max. no. of records per page
+      @param orderField The field to sort the result
+     */
+    DQSharedPaginator(const DQSharedQuery& query , int pageSize , QString orderField = "id");
+
+    /// The max. no. of records per page
+    int pageSize() const;
+
+    /// The field to sort the result
+    QString orderField() const;
+
+    /// Read the next page
+    /**
+      An empty list is returned after the last page.
+     */
+    DQSharedList nextPage();
+
+    /// Returns TRUE if there may have more page
+    bool hasNext() const;
+
+    /// No. of pages read
+    int pageCount() const;
+
+    /// The key of the last record read
+    QVariant lastKey() const;
+
+    /// The id of the last record read
+    QVariant lastId() const;
+
+    /// Continue from a record. The next page starts after it.
+    /**
+      It is useful to resume the pagination with the lastKey() / lastId() of another paginator.
+      If id is null , all the records with the same key are skipped.
+     */
+    void seek(QVariant key , QVariant id = QVariant());
+
+    /// Restart from the first page
+    void reset();
+
+protected:
+    /// The query of next page
+    DQSharedQuery pageQuery();
+
+private:
+    DQSharedQuery m_query;
+
+    /// The filter of query
+    DQWhere m_where;
+
+    int m_pageSize;
+
+    QString m_orderField;
+
+    QVariant m_lastKey;
+
+    QVariant m_lastId;
+
+    int m_pageCount;
+
+    /// TRUE if the last page is read
+    bool m_end;
+};
+
+/// Keyset paginator of DQQuery
+/**
+  It is created by DQQuery::paginate().
+
+Example code:
+\code
+
+    DQPaginator<HealthCheck> paginator = DQQuery<HealthCheck>().filter(DQWhere("height") > 100).paginate(50,"name");
+
+    while (paginator.hasNext()) {
+        DQList<HealthCheck> page = paginator.nextPage();
+        // ...
+    }
+
+\endcode
+
+ */
+
+template <typename T>
+class DQPaginator : public DQSharedPaginator {
+public:
+    /// Construct a paginator for the query
+    DQPaginator(const DQSharedQuery& query , int pageSize , QString orderField = "id") :
+        DQSharedPaginator(query,pageSize,orderField) {
+    }
+
+    /// Read the next page
+    DQList<T> nextPage() {
+        return DQSharedPaginator::nextPage();
+    }
+};
+
+#endif // DQPAGINATOR_H
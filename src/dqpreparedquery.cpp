@@ -0,0 +1,92 @@
+#include <QtCore>
+#include <QSqlError>
+#include "dqpreparedquery.h"
+#include "dqqueryrules.h"
+#include "dqsql.h"
+#include "dqsharedquery_p.h"
+
+DQSharedPreparedQuery::DQSharedPreparedQuery(const DQSharedQuery& query) : m_query(query) , m_valid(false) {
+    DQConnection connection = m_query.data->connection;
+    Q_ASSERT(connection.isOpen());
+
+    QString sql = connection.sql().selectStatement(m_query);
+
+    // The tables of large in() list are filled once , before the statement refers to them.
+    // The values are fixed on construction.
+    m_prepared = connection.query();
+    m_valid = m_query.loadValueTables() && m_prepared.prepare(sql);
+
+    if (!m_valid) {
+        connection.setLastQuery(m_prepared);
+        qWarning() << QString("DQPreparedQuery - Failed to prepare %1 . Error : %2")
+                      .arg(sql).arg(m_prepared.lastError().text());
+    }
+
+    DQQueryRules rules;
+    rules = m_query;
+    m_values = m_query.bindValues();
+    m_params = rules.expression().params();
+
+    if (!rules.groupBy().isEmpty() && !rules.havingExpression().isNull()) {
+        // The values of HAVING are placed after the values of WHERE
+        int offset = rules.expression().bindValues().size();
+        QMapIterator<QString,QList<int> > iter(rules.havingExpression().params());
+        while (iter.hasNext()) {
+            iter.next();
+            foreach (int pos , iter.value()) {
+                m_params[iter.key()] << pos + offset;
+            }
+        }
+    }
+}
+
+bool DQSharedPreparedQuery::isValid() const {
+    return m_valid;
+}
+
+QStringList DQSharedPreparedQuery::params() const {
+    return m_params.keys();
+}
+
+DQSharedPreparedQuery& DQSharedPreparedQuery::bind(QString name , QVariant value){
+    QMap<QString,QList<int> >::const_iterator iter = m_params.constFind(name);
+    if (iter == m_params.constEnd()) {
+        qWarning() << QString("DQPreparedQuery::bind() - %1 is not a parameter").arg(name);
+        return *this;
+    }
+
+    foreach (int pos , iter.value()) {
+        m_values[pos] = value;
+    }
+    return *this;
+}
+
+bool DQSharedPreparedQuery::exec(){
+    if (!m_valid)
+        return false;
+
+    // The tables are only filled again if they were rolled back after construction
+    if (!m_query.loadValueTables())
+        return false;
+
+    return m_query.execPrepared(m_prepared,m_values);
+}
+
+bool DQSharedPreparedQuery::next(){
+    return m_query.next();
+}
+
+void DQSharedPreparedQuery::finish(){
+    m_query.finish();
+}
+
+DQSharedList DQSharedPreparedQuery::all(){
+    if (!exec())
+        return DQSharedList();
+
+    return m_query.readAll();
+}
+
+bool DQSharedPreparedQuery::recordTo(DQAbstractModel *model){
+    return m_query.recordTo(model);
+}
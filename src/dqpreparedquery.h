@@ -0,0 +1,113 @@
+#ifndef DQPREPAREDQUERY_H
+#define DQPREPAREDQUERY_H
+
+#include <QMap>
+#include <QVector>
+#include <QSqlQuery>
+#include <dqsharedquery.h>
+#include <dqlist.h>
+
+/// DQSharedPreparedQuery is the base class of DQPreparedQuery
+/**
+  The SQL of the query is generated and prepared once on construction. The values
+  of DQParam in the filter are assigned by bind() , and the query is executed by the
+  same prepared statement every time. No DQWhere / DQExpression processing and SQL
+  generation is needed for execution.
+
+  @see DQPreparedQuery
+ */
+
+class DQSharedPreparedQuery {
+public:
+    /// Prepare the query
+    /**
+      @param query The query. Its filter may contain DQParam.
+     */
+    DQSharedPreparedQuery(const DQSharedQuery& query);
+
+    /// Returns TRUE if the query is prepared successfully
+    bool isValid() const;
+
+    /// The names of DQParam in the filter
+    QStringList params() const;
+
+    /// Assign the value of a parameter
+    /**
+      The value is kept for further execution until it is changed.
+     */
+    DQSharedPreparedQuery& bind(QString name , QVariant value);
+
+    /// Execute the query
+    bool exec();
+
+    /// Retrieves the next record in the result
+    bool next();
+
+    /// Release the result set of the query
+    void finish();
+
+    /// Execute the query and return all the record retrieved
+    DQSharedList all();
+
+protected:
+    /// Save the current record to a DQModel
+    bool recordTo(DQAbstractModel *model);
+
+private:
+    DQSharedQuery m_query;
+
+    QSqlQuery m_prepared;
+
+    bool m_valid;
+
+    /// The values to be bound by position , including the fixed values of the filter
+    QVector<QVariant> m_values;
+
+    /// Parameter name to the positions of its placeholders
+    QMap<QString,QList<int> > m_params;
+};
+
+/// A query that is prepared once and executed many times with different values
+/**
+  It is useful to run the same filter with different values repeatedly.
+
+Example code:
+\code
+
+    DQPreparedQuery<User> query(DQQuery<User>().filter(DQWhere("userId") == DQParam("uid")));
+
+    foreach (QString uid , uids) {
+        DQList<User> users = query.bind("uid",uid).all();
+        // ...
+    }
+
+\endcode
+
+  @remarks A prepared query holds its own prepared statement. It should only be used by the thread of its connection.
+ */
+
+template <typename T>
+class DQPreparedQuery : public DQSharedPreparedQuery {
+public:
+    /// Prepare the query
+    DQPreparedQuery(const DQSharedQuery& query) : DQSharedPreparedQuery(query) {
+    }
+
+    /// Assign the value of a parameter
+    DQPreparedQuery& bind(QString name , QVariant value) {
+        DQSharedPreparedQuery::bind(name,value);
+        return *this;
+    }
+
+    /// Execute the query and return all the record retrieved
+    DQList<T> all() {
+        return DQSharedPreparedQuery::all();
+    }
+
+    /// Save the current record to a DQModel
+    bool recordTo(T &model) {
+        return DQSharedPreparedQuery::recordTo(&model);
+    }
+};
+
+#endif // DQPREPAREDQUERY_H
@@ -3,6 +3,11 @@
 
 #include <dqsharedquery.h>
 #include <dqlist.h>
+#include <dqcursor.h>
+#include <dqquerystream.h>
+#include <dqpaginator.h>
+#include <dqtuple.h>
+#include <QVector>
 
 ///  DQQuery is a template class for performing database queries and record deletion on specific model
 /**
@@ -44,6 +49,38 @@ public:
         return DQSharedQuery::recordTo(&model);
     }
 
+    /// Save the first record in the order of orderBy() to the model
+    /**
+      Only a single record is read.
+
+      @return TRUE if a record is found
+     */
+    bool first(T &model) {
+        return DQSharedQuery::first(&model);
+    }
+
+    /// Save the last record in the order of orderBy() to the model
+    /**
+      The ordering terms are reversed , and only a single record is read.
+      The ordering should be unique , otherwise any of the tied records may be returned.
+
+      @return TRUE if a record is found
+      @see DQSharedQuery::last()
+     */
+    bool last(T &model) {
+        return DQSharedQuery::last(&model);
+    }
+
+    /// Returns the value of a field of the first record
+    QVariant first(QString field) {
+        return DQSharedQuery::first(field);
+    }
+
+    /// Returns the value of a field of the last record
+    QVariant last(QString field) {
+        return DQSharedQuery::last(field);
+    }
+
     /// Read the next record
     T record() {
         T t;
@@ -51,6 +88,106 @@ public:
         return t;
     }
 
+    /// Returns a forward-only cursor to iterate the result without loading all the records into memory
+    /**
+      @see DQCursor
+     */
+    DQCursor<T> iterate() {
+        return DQCursor<T>(*this);
+    }
+
+    /// Returns a stream to read the result page by page on the worker thread of the connection
+    /**
+      @param pageSize The max. no. of records read per page
+      @see DQQueryStream
+     */
+    DQQueryStream<T> stream(int pageSize = DQSharedQueryStream::DefaultPageSize) {
+        return DQQueryStream<T>(*this,pageSize);
+    }
+
+    /// Returns a keyset paginator of the result
+    /**
+      @param pageSize The max. no. of records per page
+      @param orderField The field to sort the result. An index on it is recommended.
+      @see DQPaginator
+     */
+    DQPaginator<T> paginate(int pageSize , QString orderField = "id") {
+        return DQPaginator<T>(*this,pageSize,orderField);
+    }
+
+    /// Returns the value of a field of all the records retrieved
+    /**
+      The values are read from the result columns directly. No model is created.
+
+Example:
+\code
+    QVector<int> heights = DQQuery<HealthCheck>().values<int>("height");
+\endcode
+     */
+    template <typename T1>
+    QVector<T1> values(QString field1) {
+        QVector<T1> res;
+        DQSharedQuery query = select(field1);
+        if (query.exec(true)) {
+            while (query.next()) {
+                res.append(query.value(0).value<T1>());
+            }
+            query.finish();
+        }
+        return res;
+    }
+
+    /// Returns the values of 2 fields of all the records retrieved as DQTuple
+    /**
+      @see DQTuple
+     */
+    template <typename T1 , typename T2>
+    QVector<DQTuple<T1,T2> > values(QString field1 , QString field2) {
+        QVector<DQTuple<T1,T2> > res;
+        DQSharedQuery query = select(QStringList() << field1 << field2);
+        if (query.exec(true)) {
+            while (query.next()) {
+                res.append(DQTuple<T1,T2>(query.value(0).value<T1>(),
+                                          query.value(1).value<T2>()));
+            }
+            query.finish();
+        }
+        return res;
+    }
+
+    /// Returns the values of 3 fields of all the records retrieved as DQTuple
+    template <typename T1 , typename T2 , typename T3>
+    QVector<DQTuple<T1,T2,T3> > values(QString field1 , QString field2 , QString field3) {
+        QVector<DQTuple<T1,T2,T3> > res;
+        DQSharedQuery query = select(QStringList() << field1 << field2 << field3);
+        if (query.exec(true)) {
+            while (query.next()) {
+                res.append(DQTuple<T1,T2,T3>(query.value(0).value<T1>(),
+                                             query.value(1).value<T2>(),
+                                             query.value(2).value<T3>()));
+            }
+            query.finish();
+        }
+        return res;
+    }
+
+    /// Returns the values of 4 fields of all the records retrieved as DQTuple
+    template <typename T1 , typename T2 , typename T3 , typename T4>
+    QVector<DQTuple<T1,T2,T3,T4> > values(QString field1 , QString field2 , QString field3 , QString field4) {
+        QVector<DQTuple<T1,T2,T3,T4> > res;
+        DQSharedQuery query = select(QStringList() << field1 << field2 << field3 << field4);
+        if (query.exec(true)) {
+            while (query.next()) {
+                res.append(DQTuple<T1,T2,T3,T4>(query.value(0).value<T1>(),
+                                                query.value(1).value<T2>(),
+                                                query.value(2).value<T3>(),
+                                                query.value(3).value<T4>()));
+            }
+            query.finish();
+        }
+        return res;
+    }
+
 };
 
 template <typename T>
@@ -30,6 +30,14 @@ int DQQueryRules::limit(){
     return data->limit;
 }
 
+int DQQueryRules::offset(){
+    return data->offset;
+}
+
+DQWhere DQQueryRules::where(){
+    return data->where;
+}
+
 DQExpression DQQueryRules::expression(){
     return data->expression;
 }
@@ -49,3 +57,27 @@ QStringList DQQueryRules::fields(){
 QStringList DQQueryRules::orderBy() {
     return data->orderBy;
 }
+
+QStringList DQQueryRules::groupBy() {
+    return data->groupBy;
+}
+
+DQWhere DQQueryRules::having() {
+    return data->having;
+}
+
+DQExpression DQQueryRules::havingExpression() {
+    return data->havingExpression;
+}
+
+QStringList DQQueryRules::selectRelated() {
+    return data->selectRelated;
+}
+
+bool DQQueryRules::reverseWindow() {
+    return data->reverseWindow;
+}
+
+DQConnection DQQueryRules::connection() {
+    return data->connection;
+}
@@ -24,8 +24,14 @@ public:
     /// Get the limit of query
     int limit();
 
+    /// Get the offset of query
+    int offset();
+
     DQExpression expression();
 
+    /// Get the filter of query
+    DQWhere where();
+
     /// Get the func that should be applied on result column
     QString func();
 
@@ -38,6 +44,24 @@ public:
     /// Get the field for orderBy
     QStringList orderBy();
 
+    /// Get the fields for groupBy
+    QStringList groupBy();
+
+    /// Get the filter of groups
+    DQWhere having();
+
+    /// Get the expression of the filter of groups
+    DQExpression havingExpression();
+
+    /// Get the foreign keys that should be joined by select
+    QStringList selectRelated();
+
+    /// Returns TRUE if the window of limit / offset should be read in reversed order
+    bool reverseWindow();
+
+    /// Get the connection of query
+    DQConnection connection();
+
 private:
     QSharedDataPointer<DQSharedQueryPriv> data;
 };
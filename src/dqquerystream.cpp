@@ -0,0 +1,157 @@
+#include <QtCore>
+#include "dqquerystream.h"
+#include "dqsharedquery_p.h"
+#include "dqasync.h"
+
+/// The state of DQSharedQueryStream shared with the worker thread
+/**
+  Except the constructor , it is only accessed by the worker thread. It may be destroyed by
+  the calling thread , so finish() releases the connection of worker thread before that.
+ */
+
+class DQSharedQueryStreamPriv {
+public:
+    DQSharedQueryStreamPriv(const DQSharedQuery& q , int size) : query(q) , pageSize(size) {
+        source = q.data->connection;
+        // Detach from the prepared query of calling thread
+        query.data->query = QSqlQuery();
+        started = false;
+        finished = false;
+    }
+
+    /// Read the next page by the connection of worker thread
+    DQSharedList fetch(DQConnection connection) {
+        DQSharedList res;
+
+        if (finished)
+            return res;
+
+        if (!started) {
+            started = true;
+            query.setConnection(connection);
+            if (!query.exec(true)) {
+                finish();
+                return res;
+            }
+        }
+
+        while (res.size() < pageSize) {
+            if (!query.next()) {
+                finish();
+                break;
+            }
+            DQAbstractModel *model = res.appendNew(query.data->metaInfo);
+            query.recordTo(model);
+        }
+
+        int n = res.size();
+        for (int i = 0 ; i < n ; i++) {
+            DQModel *model = dynamic_cast<DQModel*>(res.at(i));
+            if (model)
+                model->setConnection(source);
+        }
+
+        return res;
+    }
+
+    /// Release the result set and the connection of worker thread
+    void finish() {
+        if (started)
+            query.finish();
+        query.data->query = QSqlQuery();
+        query.setConnection(DQConnection());
+        finished = true;
+    }
+
+    /// The connection of calling thread
+    DQConnection source;
+
+    DQSharedQuery query;
+
+    int pageSize;
+
+    bool started;
+
+    bool finished;
+};
+
+class DQStreamFetchTask : public DQAsyncResultTask<DQSharedList> {
+public:
+    DQStreamFetchTask(QSharedPointer<DQSharedQueryStreamPriv> priv) : d(priv) {
+    }
+
+protected:
+    DQSharedList exec(DQConnection connection) {
+        return d->fetch(connection);
+    }
+
+private:
+    QSharedPointer<DQSharedQueryStreamPriv> d;
+};
+
+class DQStreamFinishTask : public DQAsyncResultTask<bool> {
+public:
+    DQStreamFinishTask(QSharedPointer<DQSharedQueryStreamPriv> priv) : d(priv) {
+    }
+
+protected:
+    bool exec(DQConnection connection) {
+        Q_UNUSED(connection);
+        d->finish();
+        return true;
+    }
+
+private:
+    QSharedPointer<DQSharedQueryStreamPriv> d;
+};
+
+DQSharedQueryStream::DQSharedQueryStream(const DQSharedQuery& query , int pageSize) :
+    m_query(query) ,
+    m_pageSize(qMax(pageSize,1)) ,
+    m_closed(false)
+{
+}
+
+DQSharedQueryStream::DQSharedQueryStream(const DQSharedQueryStream& rhs) :
+    m_query(rhs.m_query) ,
+    m_pageSize(rhs.m_pageSize) ,
+    m_closed(false)
+{
+}
+
+DQSharedQueryStream::~DQSharedQueryStream(){
+    close();
+}
+
+int DQSharedQueryStream::pageSize() const {
+    return m_pageSize;
+}
+
+QFuture<DQSharedList> DQSharedQueryStream::fetchPage(){
+    if (d.isNull())
+        d = QSharedPointer<DQSharedQueryStreamPriv>(new DQSharedQueryStreamPriv(m_query,m_pageSize));
+
+    DQStreamFetchTask *task = new DQStreamFetchTask(d);
+    QFuture<DQSharedList> future = task->future();
+    d->source.runAsync(task);
+    return future;
+}
+
+DQSharedList DQSharedQueryStream::nextPage(){
+    QFuture<DQSharedList> future = fetchPage();
+    future.waitForFinished();
+
+    // Canceled if the connection is closed
+    if (future.resultCount() == 0)
+        return DQSharedList();
+
+    return future.result();
+}
+
+void DQSharedQueryStream::close(){
+    if (d.isNull() || m_closed)
+        return;
+
+    m_closed = true;
+    d->source.runAsync(new DQStreamFinishTask(d));
+}
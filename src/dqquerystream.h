@@ -0,0 +1,212 @@
+#ifndef DQQUERYSTREAM_H
+#define DQQUERYSTREAM_H
+
+#include <QFuture>
+#include <QSharedPointer>
+#include <dqsharedquery.h>
+#include <dqsharedlist.h>
+
+class DQSharedQueryStreamPriv;
+
+/// DQSharedQueryStream is the base class of DQQueryStream that reads the result of a query page by page
+/**
+  The query is executed in forward-only mode by the worker thread of the
+  connection (DQConnection::runAsync()). Every call of fetchPage() queues the
+  read of next page. So the result set is never loaded at once.
+
+  The stream is closed on destruction. The result set on the worker thread
+  is released even the stream is not read to the end.
+
+  @see DQQueryStream
+ */
+
+class DQSharedQueryStream {
+public:
+    enum {
+        /// The default no. of records per page
+        DefaultPageSize = 500
+    };
+
+    /// Construct a stream for the query
+    DQSharedQueryStream(const DQSharedQuery& query , int pageSize = DefaultPageSize);
+
+    /// Construct a stream with the same query as other stream. It is not started yet.
+    DQSharedQueryStream(const DQSharedQueryStream& rhs);
+
+    /// Destructor. The stream is closed.
+    ~DQSharedQueryStream();
+
+    /// The max. no. of records per page
+    int pageSize() const;
+
+    /// Read the next page on the worker thread
+    /**
+      The query is executed on first call. The returned page has less than pageSize()
+      records if it is the last page. An empty list is returned after the end of result
+      or the stream is closed.
+
+      Use QFutureWatcher to be notified in the calling thread when the page is ready.
+     */
+    QFuture<DQSharedList> fetchPage();
+
+    /// Read the next page and wait for the result
+    DQSharedList nextPage();
+
+    /// Release the result set and the connection of worker thread. No more record could be read.
+    void close();
+
+private:
+    DQSharedQueryStream& operator=(const DQSharedQueryStream& rhs);
+
+    DQSharedQuery m_query;
+
+    int m_pageSize;
+
+    /// TRUE if close() is called
+    bool m_closed;
+
+    /// The state shared with the worker thread. It is created by the first fetchPage().
+    QSharedPointer<DQSharedQueryStreamPriv> d;
+};
+
+/// A stream of the result of a query that keeps only a single page of records in memory
+/**
+  It is created by DQQuery::stream(). The filter() , orderBy() and limit() of the query
+  are applied.
+
+Example code:
+\code
+
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().orderBy("name");
+
+    DQQueryStream<HealthCheck> stream = query.stream(1000);
+    for (DQQueryStream<HealthCheck>::iterator iter = stream.begin() ; iter != stream.end() ; ++iter) {
+        qDebug() << iter->name;
+        if (iter->name() == "tester")
+            break; // The result set is released by the destructor of stream
+    }
+
+\endcode
+
+  @remarks The stream could only be iterated once. The models are destroyed when the iterator moved to next page.
+  @see DQCursor
+ */
+
+template <typename T>
+class DQQueryStream : public DQSharedQueryStream {
+public:
+
+    /// Input iterator of DQQueryStream
+    class iterator {
+    public:
+        /// Construct an end iterator
+        iterator() : m_stream(0) , m_index(0) {
+        }
+
+        /// Construct an iterator positioned on first record of current page of the stream
+        explicit iterator(DQQueryStream *stream) : m_stream(stream) , m_index(0) {
+        }
+
+        /// Returns the current record
+        T& operator*() const {
+            return *static_cast<T*>(m_stream->m_page.at(m_index));
+        }
+
+        /// Access the current record
+        T* operator->() const {
+            return static_cast<T*>(m_stream->m_page.at(m_index));
+        }
+
+        /// Move to next record. The next page is read if it is the last record of current page.
+        iterator& operator++() {
+            if (!m_stream)
+                return *this;
+
+            m_index++;
+            if (m_index < m_stream->m_page.size())
+                return *this;
+
+            m_index = 0;
+            if (!m_stream->fetch())
+                m_stream = 0;
+
+            return *this;
+        }
+
+        bool operator==(const iterator& rhs) const {
+            return m_stream == rhs.m_stream && m_index == rhs.m_index;
+        }
+
+        bool operator!=(const iterator& rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        DQQueryStream *m_stream;
+        int m_index;
+    };
+
+    /// Construct a stream for the query
+    explicit DQQueryStream(const DQSharedQuery& query , int pageSize = DefaultPageSize) :
+        DQSharedQueryStream(query,pageSize) , m_started(false) , m_end(false) {
+    }
+
+    /// Construct a stream with the same query as other stream. It is not started yet.
+    DQQueryStream(const DQQueryStream& rhs) : DQSharedQueryStream(rhs) , m_started(false) , m_end(false) {
+    }
+
+    /// Read the first page and return the iterator of first record
+    /**
+      It could only be called once. The end iterator will be returned for any further call.
+     */
+    iterator begin() {
+        if (m_started)
+            return iterator();
+
+        m_started = true;
+
+        if (!fetch())
+            return iterator();
+
+        return iterator(this);
+    }
+
+    /// Returns the end iterator
+    iterator end() {
+        return iterator();
+    }
+
+private:
+    DQQueryStream& operator=(const DQQueryStream& rhs);
+
+    /// Replace the current page by next page. Return FALSE if no more record.
+    bool fetch() {
+        if (m_end) {
+            m_page = DQSharedList();
+            return false;
+        }
+
+        // Release current page before reading next page
+        m_page = DQSharedList();
+        m_page = nextPage();
+
+        if (m_page.size() < pageSize()) {
+            m_end = true;
+            close();
+        }
+
+        return m_page.size() > 0;
+    }
+
+    /// The records of current page
+    DQSharedList m_page;
+
+    bool m_started;
+
+    /// TRUE if the last page is read
+    bool m_end;
+
+    friend class iterator;
+};
+
+#endif // DQQUERYSTREAM_H
@@ -1,27 +1,137 @@
 #include "dqsharedlist.h"
 #include <QSharedData>
 #include <QList>
+#include "dqmodel.h"
+#include "dqsql.h"
+
+/// The default no. of items saved in a transaction
+#define DQ_SAVE_CHUNK_SIZE 1000
+
+/// The alignment of model allocated by arena
+#define DQ_ARENA_ALIGNMENT 16
+
+/// The size of the first block of arena
+#define DQ_ARENA_MIN_BLOCK_SIZE 4096
+
+/// The max. size of a block of arena. The block size is doubled until it reach this value
+#define DQ_ARENA_MAX_BLOCK_SIZE (1024 * 1024)
+
+/// A bump allocator for the models owned by DQSharedList
+/**
+  The models are placed contiguously in large blocks. The memory is released
+  block by block on clear() instead of model by model.
+ */
+class DQModelArena {
+public:
+    DQModelArena() {
+        blockSize = DQ_ARENA_MIN_BLOCK_SIZE;
+        current = 0;
+        used = 0;
+        capacity = 0;
+    }
+
+    ~DQModelArena() {
+        clear();
+    }
+
+    /// Allocate memory for a model
+    void* allocate(int size) {
+        size = (size + DQ_ARENA_ALIGNMENT - 1) & ~(DQ_ARENA_ALIGNMENT - 1);
+
+        if (current == 0 || used + size > capacity) {
+            while (blockSize < size)
+                blockSize *= 2;
+
+            current = new char[blockSize];
+            used = 0;
+            capacity = blockSize;
+            blocks[current] = blockSize;
+
+            if (blockSize < DQ_ARENA_MAX_BLOCK_SIZE)
+                blockSize *= 2;
+        }
+
+        void *res = current + used;
+        used += size;
+        return res;
+    }
+
+    /// TRUE if the model is allocated by the arena
+    bool owns(const void *model) const {
+        const char *p = (const char*) model;
+        QMap<const char*,int>::const_iterator iter = blocks.upperBound(p);
+        if (iter == blocks.constBegin())
+            return false;
+        --iter;
+        return p < iter.key() + iter.value();
+    }
+
+    /// Release all the blocks. The models must be destroyed before.
+    void clear() {
+        QMapIterator<const char*,int> iter(blocks);
+        while (iter.hasNext()) {
+            iter.next();
+            delete [] iter.key();
+        }
+        blocks.clear();
+        blockSize = DQ_ARENA_MIN_BLOCK_SIZE;
+        current = 0;
+        used = 0;
+        capacity = 0;
+    }
+
+    /// Allocated blocks (address to size)
+    QMap<const char*,int> blocks;
+
+    /// The size of next block
+    int blockSize;
+
+    /// The block for allocation
+    char *current;
+    int used;
+    int capacity;
+};
 
 class DQSharedListPriv : public QSharedData {
 public:
     DQSharedListPriv() {
         metaInfo = 0;
+        saveChunkSize = DQ_SAVE_CHUNK_SIZE;
+        arena = 0;
     }
 
     ~DQSharedListPriv() {
         clear();
+        delete arena;
     }
 
     void clear(){
         foreach (DQAbstractModel*model, list){
-            delete model;
+            destroy(model);
         }
         list.clear();
         metaInfo = 0;
+
+        if (arena)
+            arena->clear();
+    }
+
+    /// Destroy a model owned by the list
+    void destroy(DQAbstractModel *model) {
+        if (arena && arena->owns(model)) {
+            model->~DQAbstractModel();
+        } else {
+            delete model;
+        }
     }
 
     QList <DQAbstractModel*> list;
     DQModelMetaInfo *metaInfo;
+
+    int saveChunkSize;
+
+    /// The allocator of appendNew(). NULL if it is not enabled.
+    DQModelArena *arena;
 };
 
 DQSharedList::DQSharedList() : data(new DQSharedListPriv){
@@ -67,23 +177,103 @@ void DQSharedList::clear() {
 void DQSharedList::removeAt(int index){
     DQAbstractModel *model = data->list.value(index);
     data->list.removeAt(index);
-    delete model;
+    data->destroy(model); // The memory of arena is only released by clear()
+}
+
+DQAbstractModel* DQSharedList::appendNew(DQModelMetaInfo *metaInfo){
+    if (data->metaInfo && metaInfo != data->metaInfo) {
+        return 0;
+    }
+
+    DQAbstractModel *model;
+
+    if (data->arena) {
+        model = metaInfo->create(data->arena->allocate(metaInfo->objectSize()));
+    } else {
+        model = metaInfo->create();
+    }
+
+    data->list << model;
+    return model;
+}
+
+void DQSharedList::setArenaEnabled(bool enabled){
+    if (enabled) {
+        if (!data->arena)
+            data->arena = new DQModelArena();
+        return;
+    }
+
+    if (!data->arena)
+        return;
+
+    if (!data->list.isEmpty()) {
+        qWarning() << "DQSharedList::setArenaEnabled() - The arena could not be disabled until the list is cleared";
+        return;
+    }
+
+    delete data->arena;
+    data->arena = 0;
+}
+
+bool DQSharedList::isArenaEnabled() const{
+    return data->arena != 0;
 }
 
 bool DQSharedList::save(bool forceInsert,bool forceAllField) {
     int n = size();
     bool res = true;
+    int chunkSize = data->saveChunkSize;
+
+    DQConnection connection;
+    bool hasConnection = false;
+    DQTransaction transaction;
+    int count = 0; // No. of items saved in current transaction
 
     for (int i = 0 ; i < n ;i++){
         DQAbstractModel* model = at(i);
+        DQModel* m = dynamic_cast<DQModel*>(model);
+
+        if (m) {
+            DQConnection modelConnection = m->connection();
+
+            if (!hasConnection ||
+                modelConnection != connection ||
+                (chunkSize > 0 && count >= chunkSize)) {
+
+                if (transaction.isActive() && !transaction.commit())
+                    return false;
+
+                connection = modelConnection;
+                hasConnection = true;
+                transaction = connection.transaction();
+                count = 0;
+            }
+        }
+
         if (!model->save(forceInsert,forceAllField)) {
-            res = false;
+            // Do not leave a partial chunk in database
+            if (transaction.isActive())
+                transaction.rollback();
+            return false;
         }
+        count++;
     }
 
+    if (transaction.isActive() && !transaction.commit())
+        res = false;
+
     return res;
 }
 
+void DQSharedList::setSaveChunkSize(int size){
+    data->saveChunkSize = size;
+}
+
+int DQSharedList::saveChunkSize() const{
+    return data->saveChunkSize;
+}
+
 DQModelMetaInfo* DQSharedList::metaInfo(){
     return data->metaInfo;
 }
@@ -63,6 +63,17 @@ public:
      */
     bool append(DQAbstractModel* model);
 
+    /// Construct a new model at the end of the list
+    /**
+      The model is owned by the list. If the arena is enabled , it is allocated from
+      the arena instead of the heap.
+
+      @param metaInfo The meta info of the model type
+      @return The new model or NULL if the list is binded to other model type
+      @see setArenaEnabled
+     */
+    DQAbstractModel* appendNew(DQModelMetaInfo *metaInfo);
+
     /// Removes all items from the list.
     void clear();
 
@@ -71,6 +82,13 @@ public:
 
     /// Save all the contained item to database
     /**
+      The items are saved in transactions of saveChunkSize() rows. The prepared
+      query is reused for items with the same set of fields. If there has an active
+      DQTransaction , the chunks will be saved as nested transactions.
+
+      If an item could not be saved , its chunk is rolled back and the rest of items are
+      not saved. The chunks before it are already committed.
+
       @param forceInsert  TRUE if the data should be inserted to the database as a new record regardless of the original id. The id field will be updated after operation.
       @param forceAllField TRUE if all the field should be saved no matter it is null or not. If false, then null field will be skipped.
       @see DQModel::save()
@@ -80,6 +98,33 @@ public:
 
     bool save(bool forceInsert = false,bool forceAllField = false);
 
+    /// Set the max. no. of items saved in a single transaction by save()
+    /**
+      A huge list saved in a single transaction will hold the write lock of
+      database until it is finished. The default value is 1000. Zero means
+      the whole list will be saved in a single transaction.
+     */
+    void setSaveChunkSize(int size);
+
+    /// The max. no. of items saved in a single transaction by save()
+    int saveChunkSize() const;
+
+    /// Enable / disable the arena allocator of appendNew()
+    /**
+      The models created by appendNew() are placed contiguously in a few large
+      memory blocks owned by the list. The blocks are released in one shot by clear()
+      or the destruction of the list. It saves a heap allocation per model for
+      large result set (e.g DQQuery::useArena()).
+
+      The arena could only be disabled when the list is empty.
+
+      @remarks The models allocated by the arena must not be deleted by "delete". Use removeAt() / clear().
+     */
+    void setArenaEnabled(bool enabled);
+
+    /// TRUE if the arena allocator is enabled
+    bool isArenaEnabled() const;
+
     /// Get the binded model's meta info
     /** If this function non-null value , then this object is binded
       to specific model, it could only be used to store single model type.
@@ -1,5 +1,6 @@
 #include <QSharedData>
 #include <QSqlRecord>
+#include <QSet>
 
 #include "dqsql.h"
 #include "dqconnection.h"
@@ -7,6 +8,7 @@
 #include "dqsharedquery_p.h"
 #include "dqsqlstatement.h"
 #include "dqexpression.h"
+#include "dqasync.h"
 
 DQSharedQuery::DQSharedQuery() : data(new DQSharedQueryPriv) {
     data->connection = DQConnection::defaultConnection();
@@ -57,6 +59,7 @@ DQSharedQuery DQSharedQuery::select(QString field) {
 DQSharedQuery DQSharedQuery::filter(DQWhere where) {
     DQSharedQuery query(*this);
     query.data->expression = DQExpression(where);
+    query.data->where = where;
     return query;
 }
 
@@ -66,6 +69,12 @@ DQSharedQuery DQSharedQuery::limit(int val){
     return query;
 }
 
+DQSharedQuery DQSharedQuery::offset(int val){
+    DQSharedQuery query(*this);
+    query.data->offset = val;
+    return query;
+}
+
 DQSharedQuery DQSharedQuery::orderBy(QStringList terms){
     DQSharedQuery query(*this);
     query.data->orderBy = terms;
@@ -80,26 +89,68 @@ DQSharedQuery DQSharedQuery::orderBy(QString term){
     return query;
 }
 
+DQSharedQuery DQSharedQuery::groupBy(QStringList fields){
+    DQSharedQuery query(*this);
+    query.data->groupBy = fields;
+    return query;
+}
+
+DQSharedQuery DQSharedQuery::groupBy(QString field){
+    DQSharedQuery query(*this);
+    QStringList fields;
+    fields << field;
+    query.data->groupBy = fields;
+    return query;
+}
+
+DQSharedQuery DQSharedQuery::having(DQWhere where){
+    DQSharedQuery query(*this);
+    query.data->havingExpression = DQExpression(where,"dq_having_in_");
+    query.data->having = where;
+    return query;
+}
+
+DQSharedQuery DQSharedQuery::prefetch(QString field){
+    DQSharedQuery query(*this);
+    if (!query.data->prefetch.contains(field))
+        query.data->prefetch << field;
+    return query;
+}
+
+DQSharedQuery DQSharedQuery::selectRelated(QString field){
+    DQSharedQuery query(*this);
+    if (!query.data->selectRelated.contains(field))
+        query.data->selectRelated << field;
+    return query;
+}
+
+DQSharedQuery DQSharedQuery::useArena(bool enabled){
+    DQSharedQuery query(*this);
+    query.data->arena = enabled;
+    return query;
+}
+
 bool DQSharedQuery::exec() {
-    data->query = data->connection.query();
+    return exec(false);
+}
 
+bool DQSharedQuery::exec(bool forwardOnly) {
     Q_ASSERT(data->connection.isOpen());
 
+    if (!loadValueTables())
+        return false;
+
     QString sql;
-    sql = data->connection.sql().statement()->select(*this);
+    sql = data->connection.sql().selectStatement(*this);
 
-    data->query.prepare(sql);
+    data->query = data->connection.sql().prepare(sql);
+    // The prepared query may be reused from the statement cache , so always set it
+    data->query.setForwardOnly(forwardOnly);
 
-    DQExpression& expression = data->expression;
-    QMap<QString,QVariant> values = expression.bindValues();
-    QMapIterator<QString, QVariant> iter(values);
-
-    while (iter.hasNext()) {
-        iter.next();
-        data->query.bindValue(iter.key() , iter.value());
-    }
+    bindTo(data->query,bindValues());
 
     bool res = data->query.exec();
+    data->columnsMapped = false;
 
     data->connection.setLastQuery(data->query);
 
@@ -111,23 +162,98 @@ bool DQSharedQuery::exec() {
 }
 
 bool DQSharedQuery::remove(){
-    data->query = data->connection.query();
+    if (!loadValueTables())
+        return false;
 
     QString sql;
-    sql = data->connection.sql().statement()->deleteFrom(*this);
+    sql = data->connection.sql().deleteStatement(*this);
+
+    data->query = data->connection.sql().prepare(sql);
 
-    data->query.prepare(sql);
+    bindTo(data->query,data->expression.bindValues());
+
+    bool res = data->query.exec();
+    data->query.finish();
+
+    data->connection.setLastQuery(data->query);
 
-    DQExpression &expression = data->expression;
-    QMap<QString,QVariant> values = expression.bindValues();
-    QMapIterator<QString, QVariant> iter(values);
+    return res;
+}
 
+/// Add the value tables of an expression to the map
+static void addValueTables(QMap<QString,QList<QVariant> >& tables , DQExpression expression){
+    QMapIterator<QString,QList<QVariant> > iter(expression.valueTables());
     while (iter.hasNext()) {
         iter.next();
-        data->query.bindValue(iter.key() , iter.value());
+        tables[iter.key()] = iter.value();
     }
+}
 
-    bool res = data->query.exec();
+int DQSharedQuery::update(QVariantMap assignments){
+    Q_ASSERT(data->metaInfo);
+
+    if (assignments.isEmpty()) {
+        return 0;
+    }
+
+    QStringList fields = data->metaInfo->fieldNameList();
+    QMap<QString,QString> values;
+    QMap<QString,QVector<QVariant> > setValues;
+
+    // The value tables of assignments are held until the statement is finished
+    QList<DQExpression> expressions;
+    QMap<QString,QList<QVariant> > tables;
+
+    // Convert the values to the format suitable for saving
+    DQAbstractModel *model = data->metaInfo->create();
+    QMapIterator<QString, QVariant> iter(assignments);
+    while (iter.hasNext()) {
+        iter.next();
+        QString field = iter.key();
+        QVariant value = iter.value();
+
+        if (!fields.contains(field)) {
+            qWarning() << QString("DQSharedQuery::update() - Unknown field : %1").arg(field);
+            delete model;
+            return -1;
+        }
+
+        if (value.userType() != qMetaTypeId<DQWhere>()) {
+            data->metaInfo->setValue(model,field,value);
+            value = data->metaInfo->value(model,field,true);
+        }
+
+        DQExpression expression(value);
+        values[field] = expression.string();
+        setValues[field] = expression.bindValues();
+        expressions << expression;
+        addValueTables(tables,expression);
+    }
+
+    delete model;
+
+    // The assignments are written in the order of field name , followed by the filter
+    QVector<QVariant> bindValues;
+    foreach (QVector<QVariant> v , setValues) {
+        bindValues << v;
+    }
+    bindValues << data->expression.bindValues();
+
+    if (!loadValueTables(tables))
+        return -1;
+
+    QString sql;
+    sql = data->connection.sql().statement()->update(*this,values);
+
+    data->query = data->connection.sql().prepare(sql);
+
+    bindTo(data->query,bindValues);
+
+    int res = -1;
+    if (data->query.exec()) {
+        res = data->query.numRowsAffected();
+    }
+    data->query.finish();
 
     data->connection.setLastQuery(data->query);
 
@@ -135,18 +261,331 @@ bool DQSharedQuery::remove(){
 }
 
 DQSharedList DQSharedQuery::all(){
+    if (!exec())
+        return DQSharedList();
+
+    return readAll();
+}
+
+DQSharedList DQSharedQuery::readAll(){
     DQSharedList res;
-    if (exec()) {
-        while (next() ) {
-            DQAbstractModel* model = data->metaInfo->create();
-            DQSharedQuery::recordTo(model);
-            res.append(model);
+    res.setArenaEnabled(data->arena);
+
+    while (next() ) {
+        DQAbstractModel* model = res.appendNew(data->metaInfo);
+        DQSharedQuery::recordTo(model);
+    }
+    finish();
+
+    if (!data->prefetch.isEmpty())
+        prefetchTo(res);
+
+    return res;
+}
+
+bool DQSharedQuery::execPrepared(QSqlQuery query,const QVector<QVariant>& values){
+    data->query = query;
+
+    bindTo(data->query,values);
+
+    // The result columns of a prepared query never change
+    bool res = data->query.exec();
+
+    if (!res) {
+        data->connection.setLastQuery(data->query);
+        qWarning() << QString("Failed : %1").arg(data->query.executedQuery());
+    }
+
+    return res;
+}
+
+QVector<QVariant> DQSharedQuery::bindValues(){
+    QVector<QVariant> res = data->expression.bindValues();
+
+    // HAVING is placed after WHERE
+    if (!data->groupBy.isEmpty() && !data->havingExpression.isNull())
+        res << data->havingExpression.bindValues();
+
+    return res;
+}
+
+bool DQSharedQuery::loadValueTables(QMap<QString,QList<QVariant> > tables){
+    addValueTables(tables,data->expression);
+    if (!data->groupBy.isEmpty() && !data->havingExpression.isNull())
+        addValueTables(tables,data->havingExpression);
+
+    if (tables.isEmpty())
+        return true;
+
+    DQSql sql = data->connection.sql();
+    QMapIterator<QString,QList<QVariant> > iter(tables);
+    while (iter.hasNext()) {
+        iter.next();
+        if (!sql.setValueTable(iter.key(),iter.value())) {
+            data->connection.setLastQuery(sql.lastQuery());
+            qWarning() << QString("DQSharedQuery - Failed to fill %1").arg(iter.key());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void DQSharedQuery::bindTo(QSqlQuery& query,const QVector<QVariant>& values){
+    const QVariant* v = values.constData();
+    int n = values.size();
+
+    for (int i = 0 ; i < n ; i++) {
+        query.bindValue(i , v[i]);
+    }
+}
+
+DQColumnSet DQSharedQuery::columns(QStringList fields){
+    Q_ASSERT(data->metaInfo);
+
+    DQColumnSet res;
+
+    if (fields.isEmpty())
+        fields = data->metaInfo->fieldNameList();
+
+    foreach (QString field , fields) {
+        int index = data->metaInfo->indexOf(field);
+        if (index < 0) {
+            qWarning() << QString("DQSharedQuery::columns() - %1 is not a field").arg(field);
+            return res;
+        }
+        res.addColumn(field,data->metaInfo->at(index)->type);
+    }
+
+    DQSharedQuery query = select(fields);
+    int n = fields.size();
+
+    if (query.exec(true)) {
+        while (query.next()) {
+            for (int i = 0 ; i < n;i++) {
+                res.append(i,query.value(i));
+            }
         }
+        query.finish();
     }
 
+    res.squeeze();
+
     return res;
 }
 
+DQColumnSet DQSharedQuery::aggregate(QList<DQAggregate> aggregates){
+    Q_ASSERT(data->metaInfo);
+
+    DQColumnSet res;
+    QStringList fields;
+
+    foreach (QString field , data->groupBy) {
+        int index = data->metaInfo->indexOf(field);
+        res.addColumn(field,index >= 0 ? data->metaInfo->at(index)->type : QVariant::String);
+        fields << field;
+    }
+
+    foreach (DQAggregate aggregate , aggregates) {
+        QString func = aggregate.func().toLower();
+        QVariant::Type type;
+
+        if (func == "count") {
+            type = QVariant::Int;
+        } else if (func == "avg" || func == "total") {
+            type = QVariant::Double;
+        } else if (func == "sum" || func == "min" || func == "max") {
+            // The result is in the type of field
+            int index = data->metaInfo->indexOf(aggregate.field());
+            type = index >= 0 ? data->metaInfo->at(index)->type : QVariant::Double;
+
+            // The sum of integers could exceed the range of field type. SQLite sums in 64-bit integer.
+            if (func == "sum" && (type == QVariant::Int || type == QVariant::UInt || type == QVariant::Bool))
+                type = QVariant::LongLong;
+        } else {
+            type = QVariant::String;
+        }
+
+        res.addColumn(aggregate.toString(),type);
+        fields << aggregate.toString();
+    }
+
+    DQSharedQuery query = select(fields);
+    int n = fields.size();
+
+    if (query.exec(true)) {
+        while (query.next()) {
+            for (int i = 0 ; i < n;i++) {
+                res.append(i,query.value(i));
+            }
+        }
+        query.finish();
+    }
+
+    res.squeeze();
+
+    return res;
+}
+
+/// Max. no. of id in a single prefetch query
+#define DQ_PREFETCH_CHUNK_SIZE 500
+
+void DQSharedQuery::prefetchTo(DQSharedList list){
+    int n = list.size();
+
+    foreach (QString field , data->prefetch) {
+        DQModelMetaInfo *target = data->metaInfo->foreignKeyMetaInfo(field);
+        if (!target) {
+            qWarning() << QString("DQSharedQuery::prefetch() - %1 is not a foreign key").arg(field);
+            continue;
+        }
+
+        // Distinct ids in the order of appearance
+        QList<QVariant> ids;
+        QSet<int> found;
+        for (int i = 0 ; i < n;i++) {
+            QVariant id = data->metaInfo->value(list.at(i),field);
+            if (id.isNull() || found.contains(id.toInt()))
+                continue;
+            found << id.toInt();
+            ids << id;
+        }
+
+        QMap<int, QSharedPointer<DQAbstractModel> > models;
+
+        for (int i = 0 ; i < ids.size(); i+= DQ_PREFETCH_CHUNK_SIZE) {
+            DQSharedQuery query(data->connection);
+            query.setMetaInfo(target);
+            query = query.filter(DQWhere("id").in(ids.mid(i,DQ_PREFETCH_CHUNK_SIZE)));
+
+            if (query.exec()) {
+                while (query.next()) {
+                    QSharedPointer<DQAbstractModel> model(target->create());
+                    query.recordTo(model.data());
+                    models[target->value(model.data(),"id").toInt()] = model;
+                }
+                query.finish();
+            }
+        }
+
+        for (int i = 0 ; i < n;i++) {
+            DQAbstractModel* model = list.at(i);
+            QVariant id = data->metaInfo->value(model,field);
+            if (id.isNull() || !models.contains(id.toInt()))
+                continue;
+
+            DQBaseField* f = data->metaInfo->field(model,field);
+            f->setLinkedModel(models.value(id.toInt()));
+        }
+    }
+}
+
+/// Copy of a query to be executed by DQConnection::runAsync()
+class DQAsyncQueryTask {
+public:
+    DQAsyncQueryTask(const DQSharedQuery& query) : m_query(query) {
+        m_source = query.data->connection;
+        // Detach from the prepared query of calling thread
+        m_query.data->query = QSqlQuery();
+    }
+
+protected:
+    /// Switch the query to the connection of worker thread
+    DQSharedQuery& query(DQConnection connection) {
+        m_query.setConnection(connection);
+        return m_query;
+    }
+
+    /// Release the prepared query before the task is deleted by the worker thread
+    void done() {
+        m_query.data->query = QSqlQuery();
+    }
+
+    DQSharedQuery m_query;
+
+    /// The connection of calling thread
+    DQConnection m_source;
+};
+
+class DQAsyncAllTask : public DQAsyncResultTask<DQSharedList> , public DQAsyncQueryTask {
+public:
+    DQAsyncAllTask(const DQSharedQuery& query) : DQAsyncQueryTask(query) {
+    }
+
+protected:
+    DQSharedList exec(DQConnection connection) {
+        DQSharedList res = query(connection).all();
+        done();
+
+        int n = res.size();
+        for (int i = 0 ; i < n ; i++) {
+            DQModel *model = dynamic_cast<DQModel*>(res.at(i));
+            if (model)
+                model->setConnection(m_source);
+        }
+
+        return res;
+    }
+};
+
+class DQAsyncCountTask : public DQAsyncResultTask<int> , public DQAsyncQueryTask {
+public:
+    DQAsyncCountTask(const DQSharedQuery& query) : DQAsyncQueryTask(query) {
+    }
+
+protected:
+    int exec(DQConnection connection) {
+        int res = query(connection).count();
+        done();
+        return res;
+    }
+};
+
+class DQAsyncCallTask : public DQAsyncResultTask<QVariant> , public DQAsyncQueryTask {
+public:
+    DQAsyncCallTask(const DQSharedQuery& query,QString func , QStringList fields) :
+        DQAsyncQueryTask(query) , m_func(func) , m_fields(fields) {
+    }
+
+protected:
+    QVariant exec(DQConnection connection) {
+        QVariant res = query(connection).call(m_func,m_fields);
+        done();
+        return res;
+    }
+
+private:
+    QString m_func;
+    QStringList m_fields;
+};
+
+QFuture<DQSharedList> DQSharedQuery::allAsync(){
+    DQAsyncAllTask *task = new DQAsyncAllTask(*this);
+    QFuture<DQSharedList> future = task->future();
+    data->connection.runAsync(task);
+    return future;
+}
+
+QFuture<int> DQSharedQuery::countAsync(){
+    DQAsyncCountTask *task = new DQAsyncCountTask(*this);
+    QFuture<int> future = task->future();
+    data->connection.runAsync(task);
+    return future;
+}
+
+QFuture<QVariant> DQSharedQuery::callAsync(QString func , QStringList fields){
+    DQAsyncCallTask *task = new DQAsyncCallTask(*this,func,fields);
+    QFuture<QVariant> future = task->future();
+    data->connection.runAsync(task);
+    return future;
+}
+
+QFuture<QVariant> DQSharedQuery::callAsync(QString func , QString field){
+    QStringList fields;
+    fields << field;
+    return callAsync(func,fields);
+}
+
 QSqlQuery DQSharedQuery::lastQuery(){
     return data->query;
 }
@@ -159,6 +598,10 @@ void DQSharedQuery::reset(){
     data->metaInfo = metaInfo;
 }
 
+void DQSharedQuery::finish(){
+    data->query.finish();
+}
+
 bool DQSharedQuery::next() {
     return data->query.next();
 }
@@ -171,6 +614,10 @@ QVariant DQSharedQuery::value() {
     return res;
 }
 
+QVariant DQSharedQuery::value(int column) {
+    return data->query.value(column);
+}
+
 int DQSharedQuery::count(){
     int res = 0;
     data->func = "count";
@@ -179,6 +626,7 @@ int DQSharedQuery::count(){
         if (next()){
             res = value().toInt();
         }
+        finish();
     }
     return res;
 }
@@ -192,6 +640,7 @@ QVariant DQSharedQuery::call(QString func , QStringList fields){
         if (next()){
             res = value();
         }
+        finish();
     }
 
     return res;
@@ -208,14 +657,188 @@ bool DQSharedQuery::recordTo(DQAbstractModel *model) {
     Q_ASSERT (data->metaInfo == model->metaInfo() );
     bool res = true;
 
-    QSqlRecord record = data->query.record();
+    if (!data->columnsMapped)
+        mapColumns();
 
-    int count = record.count();
+    bool related = !data->selectRelated.isEmpty();
+    const QVector<int> &columns = data->columns;
+    const QSqlQuery &query = data->query;
+    DQModelMetaInfo *metaInfo = data->metaInfo;
+
+    int count = columns.size();
     for (int i = 0 ; i < count;i++){
-        QString field = record.fieldName(i);
-        res = data->metaInfo->setValue(model,field,record.value(i));
-        if (!res)
+        int index = columns.at(i);
+        if (index < 0) {
+            if (related) // It is a column of joined table
+                continue;
+            res = false;
             break;
+        }
+        metaInfo->setValue(model,index,query.value(i));
+    }
+
+    // The model is now in sync with the database
+    metaInfo->setModified(model,false);
+
+    if (res && related)
+        recordRelatedTo(model);
+
+    return res;
+}
+
+void DQSharedQuery::mapColumns(){
+    QSqlRecord record = data->query.record();
+    int count = record.count();
+
+    data->columns.resize(count);
+    for (int i = 0 ; i < count;i++) {
+        data->columns[i] = data->metaInfo->indexOf(record.fieldName(i));
+    }
+
+    data->relatedColumns.clear();
+    DQSqlStatement *statement = data->connection.sql().statement();
+
+    foreach (QString foreignKey , data->selectRelated) {
+        DQModelMetaInfo *target = data->metaInfo->foreignKeyMetaInfo(foreignKey);
+        if (!target)
+            continue;
+
+        DQRelatedColumns related;
+        related.foreignKey = foreignKey;
+        related.metaInfo = target;
+        related.idColumn = record.indexOf(statement->relatedColumnName(foreignKey,"id"));
+
+        int n = target->size();
+        related.columns.resize(n);
+        for (int i = 0 ; i < n;i++) {
+            related.columns[i] = record.indexOf(statement->relatedColumnName(foreignKey,target->at(i)->name));
+        }
+
+        data->relatedColumns << related;
+    }
+
+    data->columnsMapped = true;
+}
+
+void DQSharedQuery::recordRelatedTo(DQAbstractModel *model){
+    foreach (const DQRelatedColumns &related , data->relatedColumns) {
+        if (related.idColumn < 0 || data->query.value(related.idColumn).isNull()) // No linked record
+            continue;
+
+        DQModelMetaInfo *target = related.metaInfo;
+        QSharedPointer<DQAbstractModel> linked(target->create());
+
+        int n = related.columns.size();
+        for (int i = 0 ; i < n;i++) {
+            int column = related.columns.at(i);
+            if (column >= 0)
+                target->setValue(linked.data(),i,data->query.value(column));
+        }
+        target->setModified(linked.data(),false);
+
+        data->metaInfo->field(model,related.foreignKey)->setLinkedModel(linked);
+    }
+}
+
+bool DQSharedQuery::exists(){
+    DQSharedQuery query(*this);
+    query.data->func.clear();
+    query.data->fields = QStringList() << "1";
+    query.data->orderBy.clear();
+    query.data->selectRelated.clear();
+    query.data->limit = 1;
+
+    bool res = false;
+    if (query.exec(true)) {
+        res = query.next();
+        query.finish();
+    }
+
+    return res;
+}
+
+/// Reverse the direction of an ordering term. e.g "height" to "height desc"
+static QString reverseOrderingTerm(QString term){
+    QStringList tokens = term.simplified().split(" ");
+    QString direction = tokens.last().toLower();
+
+    if (direction == "asc" || direction == "desc")
+        tokens.removeLast();
+
+    tokens << (direction == "desc" ? "asc" : "desc");
+
+    return tokens.join(" ");
+}
+
+DQSharedQuery DQSharedQuery::edgeQuery(bool reverse){
+    DQSharedQuery query(*this);
+    QStringList terms = data->orderBy;
+
+    if (terms.isEmpty())
+        terms << "id";
+
+    if (reverse && (data->limit > 0 || data->offset > 0)) {
+        // Reversing the ordering would read the last record of the whole result ,
+        // not the window of limit() / offset(). The window is sorted again by a subselect.
+        query.data->func.clear();
+        query.data->orderBy = terms;
+        query.data->selectRelated.clear();
+        query.data->reverseWindow = true;
+        return query;
+    }
+
+    if (reverse) {
+        for (int i = 0 ; i < terms.size();i++) {
+            terms[i] = reverseOrderingTerm(terms.at(i));
+        }
+    }
+
+    query.data->func.clear();
+    query.data->orderBy = terms;
+    query.data->limit = 1;
+    return query;
+}
+
+QVariant DQSharedQuery::first(QString field){
+    DQSharedQuery query = edgeQuery(false).select(field);
+
+    QVariant res;
+    if (query.exec(true)) {
+        if (query.next())
+            res = query.value(0);
+        query.finish();
+    }
+
+    return res;
+}
+
+QVariant DQSharedQuery::last(QString field){
+    DQSharedQuery query = edgeQuery(true).select(field);
+
+    QVariant res;
+    if (query.exec(true)) {
+        if (query.next())
+            res = query.value(0);
+        query.finish();
+    }
+
+    return res;
+}
+
+bool DQSharedQuery::first(DQAbstractModel* model){
+    DQSharedQuery query = edgeQuery(false);
+    return query.get(model);
+}
+
+bool DQSharedQuery::last(DQAbstractModel* model){
+    DQSharedQuery query = edgeQuery(true);
+
+    // get() is not used , as it would replace the limit of window
+    bool res = false;
+    if (query.exec()) {
+        if (query.next())
+            res = query.recordTo(model);
+        query.finish();
     }
 
     return res;
@@ -232,6 +855,7 @@ bool DQSharedQuery::get(DQAbstractModel* model){
         if (next()){
             res = recordTo(model);
         }
+        finish();
     }
 
     return res;
@@ -7,6 +7,9 @@
 #include <dqwhere.h>
 #include <dqmodelmetainfo.h>
 #include <dqsharedlist.h>
+#include <dqcolumnset.h>
+#include <dqaggregate.h>
+#include <QFuture>
 
 class DQSharedQueryPriv;
 class DQConnection;
@@ -71,6 +74,13 @@ public:
     /// Construct a new query object with limitation no. of result
     DQSharedQuery limit(int val);
 
+    /// Construct a new query object that skips no. of records in result
+    /**
+      The database still has to read and drop the skipped records. For deep pages of
+      a large table , use DQQuery::paginate() instead.
+     */
+    DQSharedQuery offset(int val);
+
     /// Construct a new query object with required sorting order
     /**
       @param terms The ordering terms
@@ -100,15 +110,116 @@ public:
      */
     DQSharedQuery orderBy(QString term);
 
+    /// Construct a new query object that group the records by the fields
+    /**
+      The aggregate results of each group could be retrieved by aggregate() , or by
+      DQQuery::values() with the aggregate functions written as fields:
+
+\code
+    QVector<DQTuple<QString,int,double> > rows = DQQuery<ExamResult>().groupBy("subject")
+                                                  .values<QString,int,double>("subject","count(id)","avg(mark)");
+\endcode
+
+      @see having()
+     */
+    DQSharedQuery groupBy(QStringList fields);
+
+    /// Construct a new query object that group the records by the field
+    /**
+      It is a overloaded function
+     */
+    DQSharedQuery groupBy(QString field);
+
+    /// Construct a new query object with the filter of groups
+    /**
+      The filter is applied after grouping. The aggregate function could be used as field:
+
+\code
+    query = query.groupBy("subject").having(DQWhere("count(id)") > 10);
+\endcode
+
+      @remarks It only takes effect with groupBy()
+     */
+    DQSharedQuery having(DQWhere where);
+
+    /// Construct a new query object that load the "linked" model of a foreign key in batch
+    /**
+      After all() is executed , the records linked by the foreign key will be loaded by
+      a "SELECT ... WHERE id IN (...)" query per 500 distinct ids, instead of a query per
+      record on access. The linked models are shared between the records that link to the same id.
+
+      @param field The name of a DQForeignKey field
+
+      Example:
+\code
+    DQList<ExamResult> results = DQQuery<ExamResult>().prefetch("uid").all();
+
+    qDebug() << results.at(0)->uid.isLoaded(); // TRUE. No query is needed to access uid->name
+\endcode
+     */
+    DQSharedQuery prefetch(QString field);
+
+    /// Construct a new query object that load the "linked" model of a foreign key by join
+    /**
+      The select statement will "LEFT JOIN" the table referenced by the foreign key. Both
+      of the record and its linked model are loaded from the same result row. So there
+      is only a single query.
+
+      @param field The name of a DQForeignKey field
+
+      Example:
+\code
+    DQList<ExamResult> results = DQQuery<ExamResult>().selectRelated("uid").all();
+
+    qDebug() << results.at(0)->uid.isLoaded(); // TRUE
+\endcode
+
+      The ordering terms of orderBy() are applied again on the joined result. A bare
+      column name (e.g "mark desc") is qualified as the main table "t0". An expression is
+      passed as is , so it should qualify a column name that is also in the joined table
+      , e.g "length(t0.name)".
+
+      @remarks It do not work with call() / count(). They will ignore the joined table.
+     */
+    DQSharedQuery selectRelated(QString field);
+
+    /// Construct a new query object that all() allocate the records from an arena
+    /**
+      The records returned by all() are placed contiguously in a few large memory
+      blocks owned by the DQList instead of a heap allocation per record.
+      It is useful for large result set.
+
+      @see DQSharedList::setArenaEnabled
+     */
+    DQSharedQuery useArena(bool enabled = true);
+
     /// Execute the query
     bool exec();
 
+    /// Execute the query
+    /**
+      @param forwardOnly If TRUE , the result could only be traversed by next(). The
+      database driver do not need to cache the retrieved records , so the memory usage is lower.
+     */
+    bool exec(bool forwardOnly);
+
     /// Retrieves the next record in the result, if available, and positions the query on the retrieved record.
     bool next();
 
+    /// Release the result set of the query
+    /**
+      The prepared query is shared with the statement cache of the connection. It could
+      only be reused by another query after the result set is released. all() , count() ,
+      call() and get() will release it automatically.
+     */
+    void finish();
+
     /// Retrieves the first field of the current record. It is useful for query like count() / max() , ... that will only have a single field result
     QVariant value();
 
+    /// Retrieves the value of a result column of the current record
+    QVariant value(int column);
+
     /// Execute the query and count no. of record retrieved
     int count();
 
@@ -132,9 +243,112 @@ public:
      */
     bool remove();
 
+    /// Update all the records fullfill the filter rules by a single "UPDATE" statement
+    /**
+      @param assignments The field name and its new value. The value could be a DQWhere expression.
+      @return No. of affected rows. -1 if it is failed (e.g unknown field).
+
+Example:
+\code
+    QVariantMap assignments;
+    assignments["weight"] = 70;
+    assignments["height"] = DQWhere("height") + 1;
+
+    DQQuery<HealthCheck> query;
+    query.filter(DQWhere("name") == "tester").update(assignments);
+\endcode
+
+      @remarks The records that have been loaded are not updated.
+     */
+    int update(QVariantMap assignments);
+
     /// Execute the query and return all the record retrieved
     DQSharedList all();
 
+    /// Execute the query and return the result as a DQColumnSet
+    /**
+      @param fields The fields to be retrieved. All the fields are retrieved if it is empty.
+
+      No model is created. The values of a field are stored in a contiguous vector.
+     */
+    DQColumnSet columns(QStringList fields = QStringList());
+
+    /// Execute the query and return the aggregate results of each group as a DQColumnSet
+    /**
+      The columns are the fields of groupBy() followed by the aggregates. The name of an
+      aggregate column is DQAggregate::toString() , e.g "avg(mark)". All the groups are
+      retrieved by a single query.
+
+      The column of "sum" over an integer field is QVariant::LongLong , such that it is
+      not truncated to the range of int.
+
+      @see DQAggregate
+     */
+    DQColumnSet aggregate(QList<DQAggregate> aggregates);
+
+    /// Execute the query on the worker thread of the connection and return all the record retrieved
+    /**
+      The query is queued by DQConnection::runAsync(). The calling thread is not blocked, and
+      the result could be retrieved by QFuture::result() or QFutureWatcher. The connection
+      of the returned models is the connection of this query.
+
+      Cancel the future before it is started will drop the query.
+
+      @remarks The query is executed on a cloned database. It does not see the uncommitted
+      records of a DQTransaction. The future is canceled if the database is in-memory.
+      @see DQConnection::runAsync()
+     */
+    QFuture<DQSharedList> allAsync();
+
+    /// Execute count() on the worker thread of the connection
+    /**
+      @see allAsync()
+     */
+    QFuture<int> countAsync();
+
+    /// Execute call() on the worker thread of the connection
+    /**
+      @see allAsync()
+     */
+    QFuture<QVariant> callAsync(QString func , QStringList fields = QStringList());
+
+    /// Execute call() on the worker thread of the connection
+    /**
+      @see allAsync()
+     */
+    QFuture<QVariant> callAsync(QString func , QString field);
+
+    /// Returns TRUE if any record matches with the filter
+    /**
+      It is executed as "SELECT 1 ... LIMIT 1". SQLite stops on the first matched
+      record , and no model is created. It is cheaper than count() > 0.
+     */
+    bool exists();
+
+    /// Returns the value of a field of the first record
+    /**
+      The records are sorted by orderBy() , or "id" if it is not set. Only a single
+      column of a single record is read , and no model is created.
+
+      @return The value of field. A null QVariant is returned if no record matches.
+     */
+    QVariant first(QString field);
+
+    /// Returns the value of a field of the last record
+    /**
+      The ordering terms of orderBy() are reversed , and a single record is read.
+      If limit() or offset() is set , the window is read by a subselect and sorted again
+      in reversed order. It is a single query , and groupBy() is respected. The linked
+      models of selectRelated() are not joined in this case , they are loaded on access.
+
+      The result is well defined only if the ordering is unique. Records with equal
+      ordering terms may be returned in any order , so append a unique field like "id"
+      to orderBy() if needed.
+
+      @see first()
+     */
+    QVariant last(QString field);
+
     /// Returns the QSqlQuery object being used
     QSqlQuery lastQuery();
 
@@ -160,11 +374,67 @@ protected:
      */
     bool get(DQAbstractModel* model);
 
+    /// Save the first record in the order of orderBy() to the model
+    bool first(DQAbstractModel* model);
+
+    /// Save the last record in the order of orderBy() to the model
+    /**
+      @see last(QString)
+     */
+    bool last(DQAbstractModel* model);
+
 
 private:
+    /// Read all the records of the executed query
+    DQSharedList readAll();
+
+    /// Execute a prepared query of this query with the values
+    /**
+      The column mapping of previous execution is reused.
+     */
+    bool execPrepared(QSqlQuery query,const QVector<QVariant>& values);
+
+    /// Construct a new query that read the first record only
+    /**
+      @param reverse TRUE if the ordering terms should be reversed to read the last record
+     */
+    DQSharedQuery edgeQuery(bool reverse);
+
+    /// The values to be bound for the filter and the filter of groups
+    QVector<QVariant> bindValues();
+
+    /// Fill the values of large in() / notIn() list to the temporary tables
+    /**
+      @param tables The tables of other expressions in the statement. e.g The assignments of update()
+
+      The tables of the filter and the filter of groups are always filled. A table that
+      already holds the values is not filled again.
+     */
+    bool loadValueTables(QMap<QString,QList<QVariant> > tables = QMap<QString,QList<QVariant> >());
+
+    /// Bind the values to the placeholders of query by position
+    static void bindTo(QSqlQuery& query,const QVector<QVariant>& values);
+
+    /// Load the linked models of prefetch() fields for the records
+    void prefetchTo(DQSharedList list);
+
+    /// Map the result columns of last exec() to the fields of models
+    void mapColumns();
+
+    /// Save the joined columns of selectRelated() fields of current record to the model
+    void recordRelatedTo(DQAbstractModel *model);
+
     QSharedDataPointer<DQSharedQueryPriv> data;
 
     friend class DQQueryRules;
+    friend class DQAsyncQueryTask;
+    friend class DQSharedQueryStreamPriv;
+    friend class DQSharedPreparedQuery;
+
+    template <typename T>
+    friend class DQCursor;
 };
 
+Q_DECLARE_METATYPE(DQSharedQuery)
+
 #endif // DQSHAREDQUERY_H
@@ -2,12 +2,27 @@
 #define DQABSTRACTQUERY_P_H
 
 #include <QSqlQuery>
+#include <QVector>
 #include "dqconnection.h"
 #include "dqmodel.h"
 #include "dqmodelmetainfo.h"
 #include "dqwhere.h"
 #include "dqexpression.h"
 
+/// The columns of a table joined by DQSharedQuery::selectRelated()
+class DQRelatedColumns {
+public:
+    QString foreignKey;
+
+    DQModelMetaInfo *metaInfo;
+
+    /// The result column of "id" field
+    int idColumn;
+
+    /// Field index of metaInfo to result column. -1 if it is not in the result.
+    QVector<int> columns;
+};
+
 /// DQSharedQuery private data
 
 class DQSharedQueryPriv : public QSharedData {
@@ -15,6 +30,10 @@ public:
     inline DQSharedQueryPriv() {
         metaInfo = 0;
         limit = -1; // No limit
+        offset = 0;
+        columnsMapped = false;
+        arena = false;
+        reverseWindow = false;
     }
 
     DQConnection connection;
@@ -24,15 +43,47 @@ public:
 
     DQModelMetaInfo *metaInfo;
     int limit;
+    int offset;
 
     QSqlQuery query;
 
     DQExpression expression;
 
+    /// The filter of expression
+    DQWhere where;
+
     /// select(fields)
     QStringList fields;
 
     QStringList orderBy;
+
+    /// groupBy(fields)
+    QStringList groupBy;
+
+    /// The filter of groups
+    DQWhere having;
+
+    DQExpression havingExpression;
+
+    /// The foreign keys to be loaded by all()
+    QStringList prefetch;
+
+    /// The foreign keys to be joined by select
+    QStringList selectRelated;
+
+    /// TRUE if all() allocate the models from arena
+    bool arena;
+
+    /// TRUE if the window of limit / offset is sorted in reversed order and only the first record is read. It is used by last().
+    bool reverseWindow;
+
+    /// TRUE if columns / relatedColumns are mapped for the result of last exec()
+    bool columnsMapped;
+
+    /// Result column to field index of metaInfo. -1 if the column is not a field.
+    QVector<int> columns;
+
+    QList<DQRelatedColumns> relatedColumns;
 };
 
 #endif // DQABSTRACTQUERY_P_H
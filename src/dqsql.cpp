@@ -1,13 +1,26 @@
 #include <QtCore>
 #include <QSqlError>
 #include <QSharedDataPointer>
+#include <QCache>
 #include "dqmodel.h"
 #include "dqsql.h"
 #include "dqsqlitestatement.h"
+#include "dqqueryrules.h"
+
+/// The default capacity of statement cache
+#define DQ_STATEMENT_CACHE_CAPACITY 64
+
+/// The default capacity of SQL cache
+#define DQ_SQL_CACHE_CAPACITY 256
 
 class DQSqlPriv : public QSharedData {
 public:
-    DQSqlPriv()  {
+    DQSqlPriv() : m_cache(DQ_STATEMENT_CACHE_CAPACITY) , m_sqlCache(DQ_SQL_CACHE_CAPACITY) {
+        m_sqlCacheHits = 0;
+        m_sqlCacheMisses = 0;
+        m_cacheHits = 0;
+        m_cacheMisses = 0;
+        m_transactionSerial = 0;
     }
 
     ~DQSqlPriv(){
@@ -21,6 +34,26 @@ public:
     QSharedPointer<QSqlQuery> m_lastQuery;
 
     QMutex m_mutex;
+
+    /// Prepared queries keyed by SQL
+    QCache<QString,QSqlQuery> m_cache;
+
+    int m_cacheHits;
+    int m_cacheMisses;
+
+    /// Generated SQL keyed by the shape of query
+    QCache<QString,QString> m_sqlCache;
+
+    int m_sqlCacheHits;
+    int m_sqlCacheMisses;
+
+    /// The id of active transactions. The last one is the innermost transaction.
+    QList<int> m_transactions;
+
+    int m_transactionSerial;
+
+    /// The values filled to each value table. The table is not filled again with the same values.
+    QHash<QString,QList<QVariant> > m_valueTables;
 };
 
 /* DQSql */
@@ -48,6 +81,9 @@ DQSql& DQSql::operator=(const DQSql &rhs){
 
 void DQSql::setStatement(DQSqlStatement *statement) {
     d->m_statement = QSharedPointer<DQSqlStatement>(statement);
+
+    QMutexLocker locker(&d->m_mutex);
+    d->m_sqlCache.clear();
 }
 
 DQSqlStatement* DQSql::statement() {
@@ -55,6 +91,8 @@ DQSqlStatement* DQSql::statement() {
 }
 
 void DQSql::setDatabase(QSqlDatabase db){
+    clearStatementCache();
+    d->m_transactions.clear();
     d->m_db = db;
 }
 
@@ -74,11 +112,281 @@ bool DQSql::createTableIfNotExists(DQModelMetaInfo* info){
     return ret;
 }
 
+bool DQSql::transaction(){
+    return begin() >= 0;
+}
+
+bool DQSql::commit(){
+    if (d->m_transactions.isEmpty())
+        return false;
+    return end(d->m_transactions.last(),true);
+}
+
+bool DQSql::rollback(){
+    if (d->m_transactions.isEmpty())
+        return false;
+    return end(d->m_transactions.last(),false);
+}
+
+int DQSql::transactionDepth(){
+    return d->m_transactions.size();
+}
+
+/// The name of savepoint for a nested transaction
+static QString savepointName(int id) {
+    return QString("dq_savepoint_%1").arg(id);
+}
+
+int DQSql::begin(){
+    int id = d->m_transactionSerial++;
+    bool res;
+
+    if (d->m_transactions.isEmpty()) {
+        res = d->m_db.transaction();
+    } else {
+        res = exec(d->m_statement->savepoint(savepointName(id)));
+    }
+
+    if (!res)
+        return -1;
+
+    d->m_transactions << id;
+
+    return id;
+}
+
+bool DQSql::end(int id,bool commit){
+    int index = d->m_transactions.indexOf(id);
+    if (index < 0) // It is already finished by the enclosing transaction
+        return false;
+
+    bool res;
+
+    if (index == 0) {
+        if (commit) {
+            res = d->m_db.commit();
+            if (!res) {
+                // Do not leave the database in the middle of transaction
+                d->m_db.rollback();
+            }
+        } else {
+            res = d->m_db.rollback();
+        }
+    } else {
+        QString name = savepointName(id);
+        if (commit) {
+            res = exec(d->m_statement->releaseSavepoint(name));
+        } else {
+            res = exec(d->m_statement->rollbackToSavepoint(name)) &&
+                  exec(d->m_statement->releaseSavepoint(name));
+        }
+    }
+
+    // The nested transactions are also finished
+    while (d->m_transactions.size() > index)
+        d->m_transactions.removeLast();
+
+    // The value tables created or filled in the transaction may be rolled back
+    if (!commit || !res) {
+        QMutexLocker locker(&d->m_mutex);
+        d->m_valueTables.clear();
+    }
+
+    return res;
+}
+
+bool DQSql::isActive(int id){
+    return d->m_transactions.contains(id);
+}
+
+bool DQSql::exec(QString sql){
+    QSqlQuery q = query();
+    bool res = q.exec(sql);
+    setLastQuery(q);
+    return res;
+}
+
 QSqlQuery DQSql::query(){
     return QSqlQuery(d->m_db);
 }
 
+QSqlQuery DQSql::prepare(QString sql){
+    QMutexLocker locker(&d->m_mutex);
+
+    QSqlQuery *cached = d->m_cache.object(sql);
+
+    if (cached && !cached->isActive()) {
+        d->m_cacheHits++;
+        return *cached;
+    }
+
+    d->m_cacheMisses++;
+
+    QSqlQuery q = query();
+    if (!q.prepare(sql)) {
+        return q;
+    }
+
+    // The cached copy share the same prepared statement with q. An active entry is
+    // replaced , otherwise the SQL would miss the cache until it is finished.
+    if (cached)
+        d->m_cache.remove(sql);
+    d->m_cache.insert(sql,new QSqlQuery(q));
+
+    return q;
+}
+
+bool DQSql::setValueTable(QString name,QList<QVariant> values){
+    {
+        // The comparison of the same list is cheap , as it is implicitly shared
+        QMutexLocker locker(&d->m_mutex);
+        QHash<QString,QList<QVariant> >::const_iterator iter = d->m_valueTables.constFind(name);
+        if (iter != d->m_valueTables.constEnd() && iter.value() == values)
+            return true;
+        d->m_valueTables.remove(name);
+    }
+
+    // A table created in a transaction is dropped if the transaction is rolled back
+    if (!exec(d->m_statement->createValueTable(name)))
+        return false;
+
+    // Fill the table in a single transaction. It is nested if there has an active one.
+    bool transaction = this->transaction();
+
+    bool res = exec(d->m_statement->clearValueTable(name));
+
+    if (res) {
+        QSqlQuery q = prepare(d->m_statement->insertIntoValueTable(name));
+        foreach (QVariant v , values) {
+            q.bindValue(0 , v);
+            if (!q.exec()) {
+                res = false;
+                break;
+            }
+        }
+        q.finish();
+        setLastQuery(q);
+    }
+
+    if (transaction) {
+        if (res) {
+            res = commit();
+        } else {
+            rollback();
+        }
+    }
+
+    if (res) {
+        QMutexLocker locker(&d->m_mutex);
+        d->m_valueTables[name] = values;
+    }
+
+    return res;
+}
+
+void DQSql::setStatementCacheCapacity(int capacity){
+    QMutexLocker locker(&d->m_mutex);
+    d->m_cache.setMaxCost(capacity);
+}
+
+int DQSql::statementCacheCapacity(){
+    return d->m_cache.maxCost();
+}
+
+int DQSql::statementCacheHits(){
+    return d->m_cacheHits;
+}
+
+int DQSql::statementCacheMisses(){
+    return d->m_cacheMisses;
+}
+
+void DQSql::clearStatementCache(){
+    QMutexLocker locker(&d->m_mutex);
+    d->m_cache.clear();
+}
+
+/// The shape of query. The queries with same shape generate the same SQL.
+/**
+  The filters are written by DQExpression::key() , so no expression is rendered to look up
+  the cache.
+ */
+static QString queryShape(QChar type , DQSharedQuery query) {
+    DQQueryRules rules;
+    rules = query;
+    const QChar separator(0x1f);
+
+    QString res;
+    res.reserve(128);
+    res.append(type);
+    res.append(rules.metaInfo()->name()).append(separator);
+    res.append(rules.func()).append(separator);
+    res.append(rules.fields().join(",")).append(separator);
+    res.append(rules.expression().key()).append(separator);
+    res.append(rules.orderBy().join(",")).append(separator);
+    res.append(rules.groupBy().join(",")).append(separator);
+    res.append(rules.havingExpression().key()).append(separator);
+    res.append(rules.selectRelated().join(",")).append(separator);
+    res.append(rules.reverseWindow() ? '1' : '0').append(separator);
+    res.append(QString::number(rules.limit())).append(separator);
+    res.append(QString::number(rules.offset()));
+
+    return res;
+}
+
+QString DQSql::cachedStatement(QChar type , DQSharedQuery query){
+    QString key = queryShape(type,query);
+
+    {
+        QMutexLocker locker(&d->m_mutex);
+        QString *cached = d->m_sqlCache.object(key);
+        if (cached) {
+            d->m_sqlCacheHits++;
+            return *cached;
+        }
+        d->m_sqlCacheMisses++;
+    }
+
+    QString sql;
+    if (type == 'S')
+        sql = d->m_statement->select(query);
+    else
+        sql = d->m_statement->deleteFrom(query);
+
+    QMutexLocker locker(&d->m_mutex);
+    d->m_sqlCache.insert(key,new QString(sql));
+
+    return sql;
+}
+
+QString DQSql::selectStatement(DQSharedQuery query){
+    return cachedStatement('S',query);
+}
+
+QString DQSql::deleteStatement(DQSharedQuery query){
+    return cachedStatement('D',query);
+}
+
+void DQSql::setSqlCacheCapacity(int capacity){
+    QMutexLocker locker(&d->m_mutex);
+    d->m_sqlCache.setMaxCost(capacity);
+}
+
+int DQSql::sqlCacheCapacity(){
+    return d->m_sqlCache.maxCost();
+}
+
+int DQSql::sqlCacheHits(){
+    return d->m_sqlCacheHits;
+}
+
+int DQSql::sqlCacheMisses(){
+    return d->m_sqlCacheMisses;
+}
+
 QSqlQuery DQSql::lastQuery(){
+    if (d->m_lastQuery == 0)
+        return QSqlQuery();
     return QSqlQuery(*d->m_lastQuery);
 }
 
@@ -168,8 +476,6 @@ bool DQSql::replaceInto(DQModelMetaInfo* info,DQModel *model,QStringList fields,
 bool DQSql::insertInto(DQModelMetaInfo* info,DQModel *model,QStringList fields,bool updateId,bool replace){
     QString sql;
 
-    QSqlQuery q = query();
-
     if (replace){
         sql = d->m_statement->replaceInto(info,fields);
     } else {
@@ -177,13 +483,11 @@ bool DQSql::insertInto(DQModelMetaInfo* info,DQModel *model,QStringList fields,b
     }
 
 //    qDebug() << sql;
-    q.prepare(sql);
+    QSqlQuery q = prepare(sql);
 
+    int i = 0;
     foreach (QString field , fields) {
-        QVariant value;
-        value = info->value(model,field,true);
-//        qDebug() << "bind " << field;
-        q.bindValue(":" + field , value);
+        q.bindValue(i++ , info->value(model,field,true));
     }
 
     bool res = false;
@@ -201,3 +505,25 @@ bool DQSql::insertInto(DQModelMetaInfo* info,DQModel *model,QStringList fields,b
 
     return res;
 }
+
+int DQSql::update(DQModelMetaInfo* info,DQModel *model,QStringList fields){
+    QString sql = d->m_statement->update(info,fields);
+
+    QSqlQuery q = prepare(sql);
+
+    int i = 0;
+    foreach (QString field , fields) {
+        q.bindValue(i++ , info->value(model,field,true));
+    }
+    q.bindValue(i , model->id.get());
+
+    int res = -1;
+
+    if (q.exec()) {
+        res = q.numRowsAffected();
+    }
+
+    setLastQuery(q);
+
+    return res;
+}
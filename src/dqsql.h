@@ -9,6 +9,7 @@
 class DQModelMetaInfo;
 class DQSqlStatement;
 class DQModel;
+class DQSharedQuery;
 
 class DQSqlStatement;
 
@@ -81,9 +82,102 @@ public:
      */
     bool replaceInto(DQModelMetaInfo* info,DQModel *model,QStringList fields,bool updateId);
 
+    /// Begin a transaction on the connected database
+    /**
+      If there has an active transaction started by DQSql, a savepoint will be
+      created as a nested transaction.
+
+      @return TRUE if the transaction is started. It will fail if the database is in a transaction that is not started by DQSql.
+      @see DQTransaction
+     */
+    bool transaction();
+
+    /// Commit the innermost transaction
+    bool commit();
+
+    /// Rollback the innermost transaction
+    bool rollback();
+
+    /// No. of nested transactions that are active
+    int transactionDepth();
+
+    /// Update the record of the model identified by its id
+    /**
+      @param info The meta information of writing model
+      @param model The data source
+      @param fields A list of fields that should be saved. The "id" field should not be included.
+      @return No. of affected rows. -1 if it is failed.
+     */
+    int update(DQModelMetaInfo* info,DQModel *model,QStringList fields);
+
     /// Create a query object to the connected database
     QSqlQuery query();
 
+    /// Create a prepared query object from the statement cache
+    /**
+      The prepared queries are cached per connection in a LRU cache keyed by the SQL. If the
+      cached query is not active , it will be returned without calling QSqlQuery::prepare()
+      again. Otherwise a new query is prepared.
+
+      @remarks Call QSqlQuery::finish() once the result is consumed. An active query could not be reused.
+     */
+    QSqlQuery prepare(QString sql);
+
+    /// Set the max. no. of prepared queries held by the statement cache. Zero disables the cache.
+    void setStatementCacheCapacity(int capacity);
+
+    /// The max. no. of prepared queries held by the statement cache
+    int statementCacheCapacity();
+
+    /// No. of prepare() served by the statement cache
+    int statementCacheHits();
+
+    /// No. of prepare() that needed to prepare a new query
+    int statementCacheMisses();
+
+    /// Remove all the prepared queries from the statement cache
+    void clearStatementCache();
+
+    /// Fill the values to a temporary table of the connection
+    /**
+      The table is created if it is not existed , and its content is replaced. It is used
+      for in() / notIn() with a large list of values.
+
+      The table is not filled again if it already holds the same values , such that a query
+      executed repeatedly only fills it once. The record is cleared when a transaction of
+      DQSql is rolled back , as the table and its content may be rolled back too.
+
+      @see DQExpression::valueTables()
+     */
+    bool setValueTable(QString name,QList<QVariant> values);
+
+    /// Returns the SELECT statement of the query
+    /**
+      The generated SQL is cached per connection by the shape of the query: the model , fields , function ,
+      filter expression , ordering terms , limit and offset. The values in the filter are bound to the
+      prepared query and are not the part of the shape. So the query with same shape but different values
+      only need to bind the values.
+     */
+    QString selectStatement(DQSharedQuery query);
+
+    /// Returns the DELETE statement of the query
+    /**
+      @see selectStatement
+     */
+    QString deleteStatement(DQSharedQuery query);
+
+    /// Set the max. no. of generated SQL held by the SQL cache. Zero disables the cache.
+    void setSqlCacheCapacity(int capacity);
+
+    /// The max. no. of generated SQL held by the SQL cache
+    int sqlCacheCapacity();
+
+    /// No. of selectStatement() / deleteStatement() served by the SQL cache
+    int sqlCacheHits();
+
+    /// No. of selectStatement() / deleteStatement() that generated the SQL
+    int sqlCacheMisses();
+
     /// The last query object
     QSqlQuery lastQuery();
 
@@ -109,12 +203,32 @@ protected:
 private:
     void setLastQuery(QSqlQuery query);
 
+    /// Returns the SQL of the query from the SQL cache. The SQL is generated on cache miss.
+    QString cachedStatement(QChar type , DQSharedQuery query);
+
+    /// Execute a SQL without result
+    bool exec(QString sql);
+
+    /// Begin a transaction
+    /**
+      @return The id of the transaction. -1 if it is failed.
+     */
+    int begin();
+
+    /// Commit or rollback the transaction and all of its nested transactions
+    bool end(int id,bool commit);
+
+    /// Return TRUE if the transaction is not finished yet
+    bool isActive(int id);
+
     bool insertInto(DQModelMetaInfo* info,DQModel *model,QStringList fields,bool with_id,bool replace);
 
     QExplicitlySharedDataPointer<DQSqlPriv> d;
 
     friend class DQConnection;
     friend class DQConnectionPriv;
+    friend class DQTransaction;
+    friend class DQTransactionPriv;
 };
 
 #endif // DQSQL_H
@@ -7,6 +7,31 @@ DQSqlStatement::DQSqlStatement()
 {
 }
 
+/// Returns TRUE if the ordering term is a bare column name , optionally followed by asc / desc
+static bool isColumnOrderingTerm(QString term){
+    QStringList tokens = term.simplified().split(" ");
+
+    if (tokens.size() > 2)
+        return false;
+
+    if (tokens.size() == 2) {
+        QString direction = tokens.at(1).toLower();
+        if (direction != "asc" && direction != "desc")
+            return false;
+    }
+
+    QString name = tokens.at(0);
+    if (name.isEmpty() || name.at(0).isDigit())
+        return false;
+
+    for (int i = 0 ; i < name.size();i++) {
+        if (!name.at(i).isLetterOrNumber() && name.at(i) != '_')
+            return false;
+    }
+
+    return true;
+}
+
 QString DQSqlStatement::dropTable(DQModelMetaInfo *info) {
     QString sql = QString("drop table %1;").arg(info->name());
     return sql;
@@ -48,8 +73,8 @@ QString DQSqlStatement::_insertInto(DQModelMetaInfo *info ,QString type, QString
 
     format = QString("%4 INTO %1 (%2) values (%3);");
 
-    foreach (QString f, fields) {
-        values << ":" + f;
+    for (int i = 0 ; i < fields.size() ; i++) {
+        values << "?";
     }
 
     sql = format.arg(info->name(), fields.join(","),values.join(",") , type);
@@ -57,21 +82,68 @@ QString DQSqlStatement::_insertInto(DQModelMetaInfo *info ,QString type, QString
     return sql;
 }
 
+QString DQSqlStatement::update(DQModelMetaInfo *info,QStringList fields){
+    QString sql,format;
+    QStringList values;
+
+    format = QString("UPDATE %1 SET %2 WHERE id = ?;");
+
+    foreach (QString f, fields) {
+        values << QString("%1 = ?").arg(f);
+    }
+
+    sql = format.arg(info->name(), values.join(","));
+
+    return sql;
+}
+
+QString DQSqlStatement::update(DQSharedQuery query,QMap<QString,QString> values){
+    DQQueryRules rules;
+    rules =  query;
+    QStringList sql;
+    QStringList assignments;
+
+    QMapIterator<QString,QString> iter(values);
+    while (iter.hasNext()) {
+        iter.next();
+        assignments << QString("%1 = %2").arg(iter.key()).arg(iter.value());
+    }
+
+    sql << QString("UPDATE %1 SET %2").arg(rules.metaInfo()->name()).arg(assignments.join(","));
+
+    DQExpression expression = rules.expression();
+    if (!expression.isNull()) {
+        sql << QString("WHERE %1").arg(expression.string());
+    }
+
+    sql << ";";
+
+    return sql.join(" ");
+}
 
 QString DQSqlStatement::select(DQSharedQuery query) {
     DQQueryRules rules;
     rules =  query;
     QStringList sql;
 
-    sql << selectCore(rules);
-    if (rules.limit() > 0 ) {
-        sql << limitAndOffset(rules.limit());
+    if (rules.func().isEmpty() && rules.selectRelated().size() > 0) {
+        return selectRelated(rules);
+    }
+
+    if (rules.reverseWindow()) {
+        return reversedWindow(rules);
     }
 
+    sql << selectCore(rules);
+
     if (rules.orderBy().size() > 0) {
         sql << orderBy(rules);
     }
 
+    if (rules.limit() > 0 || rules.offset() > 0) {
+        sql << limitAndOffset(rules.limit(),rules.offset());
+    }
+
     sql << ";";
 
     return sql.join(" ");
@@ -103,10 +175,160 @@ QString DQSqlStatement::deleteFrom(DQSharedQuery query) {
     return sql.join(" ");
 }
 
+QString DQSqlStatement::subselect(DQQueryRules rules,QString where,QString having){
+    QStringList sql;
+
+    sql << QString("SELECT %1 %2 FROM %3").arg("ALL").arg(selectResultColumn(rules)).arg(rules.metaInfo()->name());
+
+    if (!where.isEmpty()) {
+        sql << QString("WHERE %1").arg(where);
+    }
+
+    if (rules.groupBy().size() > 0) {
+        sql << groupBy(rules,having);
+    }
+
+    if (rules.orderBy().size() > 0) {
+        sql << orderBy(rules);
+    }
+
+    if (rules.limit() > 0 || rules.offset() > 0) {
+        sql << limitAndOffset(rules.limit(),rules.offset());
+    }
+
+    return sql.join(" ");
+}
+
+QString DQSqlStatement::relatedColumnName(QString foreignKey,QString field){
+    return QString("%1__%2").arg(foreignKey).arg(field);
+}
+
+QString DQSqlStatement::selectRelated(DQQueryRules rules){
+    DQModelMetaInfo *info = rules.metaInfo();
+    QStringList columns;
+    QStringList joins;
+    QStringList sql;
+    QStringList inner;
+    int n = 0;
+
+    columns << "t0.*";
+
+    foreach (QString foreignKey , rules.selectRelated()) {
+        DQModelMetaInfo *target = info->foreignKeyMetaInfo(foreignKey);
+        if (!target) {
+            qWarning() << QString("DQSqlStatement::selectRelated() - %1 is not a foreign key").arg(foreignKey);
+            continue;
+        }
+
+        QString alias = QString("t%1").arg(++n);
+
+        foreach (QString field , target->fieldNameList()) {
+            columns << QString("%1.%2 AS %3").arg(alias).arg(field).arg(relatedColumnName(foreignKey,field));
+        }
+
+        joins << QString("LEFT JOIN %1 AS %2 ON t0.%3 = %2.id").arg(target->name()).arg(alias).arg(foreignKey);
+    }
+
+    // The filter , order and limit are applied on the main table only
+    inner << selectCore(rules);
+    if (rules.orderBy().size() > 0) {
+        inner << orderBy(rules);
+    }
+    if (rules.limit() > 0 || rules.offset() > 0) {
+        inner << limitAndOffset(rules.limit(),rules.offset());
+    }
+
+    sql << QString("SELECT %1 FROM (%2) AS t0").arg(columns.join(",")).arg(inner.join(" "));
+    sql << joins;
+
+    if (rules.orderBy().size() > 0) {
+        QStringList terms;
+        foreach (QString term , rules.orderBy()) {
+            // An expression is passed as is. Only a bare column name is qualified
+            if (isColumnOrderingTerm(term))
+                terms << "t0." + term.trimmed();
+            else
+                terms << term.trimmed();
+        }
+        sql << QString("ORDER BY %1").arg(terms.join(","));
+    }
+
+    sql << ";";
+
+    return sql.join(" ");
+}
+
+QString DQSqlStatement::reversedWindow(DQQueryRules rules){
+    QStringList columns;
+    QStringList terms;
+    QStringList orderingTerms = rules.orderBy();
+    QStringList inner;
+    QStringList sql;
+
+    columns << selectResultColumn(rules);
+
+    for (int i = 0 ; i < orderingTerms.size();i++) {
+        QStringList tokens = orderingTerms.at(i).simplified().split(" ");
+        QString direction = tokens.last().toLower();
+
+        if (direction == "asc" || direction == "desc")
+            tokens.removeLast();
+
+        QString alias = QString("dq_order_%1").arg(i);
+        columns << QString("%1 AS %2").arg(tokens.join(" ")).arg(alias);
+        terms << QString("%1 %2").arg(alias).arg(direction == "desc" ? "asc" : "desc");
+    }
+
+    inner << selectCore(rules,columns.join(","));
+    if (orderingTerms.size() > 0) {
+        inner << orderBy(rules);
+    }
+    if (rules.limit() > 0 || rules.offset() > 0) {
+        inner << limitAndOffset(rules.limit(),rules.offset());
+    }
+
+    sql << QString("SELECT * FROM (%1)").arg(inner.join(" "));
+    if (terms.size() > 0) {
+        sql << QString("ORDER BY %1").arg(terms.join(","));
+    }
+    sql << limitAndOffset(1);
+    sql << ";";
+
+    return sql.join(" ");
+}
+
+QString DQSqlStatement::createValueTable(QString name){
+    return QString("CREATE TEMP TABLE IF NOT EXISTS %1 (v);").arg(name);
+}
+
+QString DQSqlStatement::insertIntoValueTable(QString name){
+    return QString("INSERT INTO %1 (v) values (?);").arg(name);
+}
+
+QString DQSqlStatement::clearValueTable(QString name){
+    return QString("DELETE FROM %1;").arg(name);
+}
+
+QString DQSqlStatement::savepoint(QString name){
+    return QString("SAVEPOINT %1;").arg(name);
+}
+
+QString DQSqlStatement::releaseSavepoint(QString name){
+    return QString("RELEASE SAVEPOINT %1;").arg(name);
+}
+
+QString DQSqlStatement::rollbackToSavepoint(QString name){
+    return QString("ROLLBACK TO SAVEPOINT %1;").arg(name);
+}
+
 QString DQSqlStatement::selectCore(DQQueryRules rules){
+    return selectCore(rules,selectResultColumn(rules));
+}
+
+QString DQSqlStatement::selectCore(DQQueryRules rules,QString resultColumn){
     QStringList res;
 
-    res << QString("SELECT %1 %2 FROM %3").arg("ALL").arg(selectResultColumn(rules)).arg(rules.metaInfo()->name());
+    res << QString("SELECT %1 %2 FROM %3").arg("ALL").arg(resultColumn).arg(rules.metaInfo()->name());
 
     DQExpression expression = rules.expression();
     if (!expression.isNull()) {
@@ -114,19 +336,33 @@ QString DQSqlStatement::selectCore(DQQueryRules rules){
         res << QString("WHERE %1").arg(expression.string());
     }
 
+    if (rules.groupBy().size() > 0) {
+        DQExpression having = rules.havingExpression();
+        res << groupBy(rules,having.isNull() ? QString() : having.string());
+    }
+
     return res.join(" ");
 }
 
 QString DQSqlStatement::selectResultColumn(DQQueryRules rules){
     QString res;
     QStringList fields = rules.fields();
+    QString func;
+    func = rules.func();
+
+    if (func.isEmpty() && fields.size() > 0) {
+        // The foreign keys are needed to join the referenced table
+        foreach (QString foreignKey , rules.selectRelated()) {
+            if (!fields.contains(foreignKey))
+                fields << foreignKey;
+        }
+    }
+
     if (fields.size() == 0)
         res = "*";
     else
         res = fields.join(",");
 
-    QString func;
-    func = rules.func();
     if (!func.isEmpty()) {
         res = QString("%1(%2)").arg(func).arg(res);
     }
@@ -135,7 +371,8 @@ QString DQSqlStatement::selectResultColumn(DQQueryRules rules){
 
 QString DQSqlStatement::limitAndOffset(int limit, int offset) {
     QStringList res;
-    res << QString("LIMIT %1").arg(limit);
+    // A negative limit means no limit. It is needed for an offset without limit.
+    res << QString("LIMIT %1").arg(limit > 0 ? limit : -1);
     if (offset > 0) {
         res << QString("OFFSET %1").arg(offset);
     }
@@ -151,6 +388,18 @@ QString DQSqlStatement::orderBy(DQQueryRules rules){
     return orderingTerms.join(" ");
 }
 
+QString DQSqlStatement::groupBy(DQQueryRules rules,QString having){
+    QStringList res;
+
+    res << QString("GROUP BY %1").arg(rules.groupBy().join(","));
+
+    if (!having.isEmpty()) {
+        res << QString("HAVING %1").arg(having);
+    }
+
+    return res.join(" ");
+}
+
 QString DQSqlStatement::formatValue(QVariant value,bool trimStrings) {
     QString res;
 
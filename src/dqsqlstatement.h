@@ -60,12 +60,53 @@ public:
      */
     virtual QString replaceInto(DQModelMetaInfo *info,QStringList fields);
 
+    /// Update statement of a single record identified by its id
+    /**
+      @param fields The fields to be updated. The "id" field should not be included.
+     */
+    virtual QString update(DQModelMetaInfo *info,QStringList fields);
+
+    /// Update statement for records matched with the filter of query
+    /**
+      @param values The field name and the SQL expression of its new value
+     */
+    virtual QString update(DQSharedQuery query,QMap<QString,QString> values);
+
     /// Select statement
     virtual QString select(DQSharedQuery query);
 
     /// Delete from statement
     virtual QString deleteFrom(DQSharedQuery query);
 
+    /// Select statement used as a subselect of another statement
+    /**
+      @param rules The rules of the subquery
+      @param where The filter expression of the subquery , which is processed with the outer statement.
+      @param having The filter expression of groups of the subquery.
+     */
+    virtual QString subselect(DQQueryRules rules,QString where,QString having = QString());
+
+    /// The alias of a column from the table joined by DQSharedQuery::selectRelated()
+    virtual QString relatedColumnName(QString foreignKey,QString field);
+
+    /// Create a savepoint
+    virtual QString savepoint(QString name);
+
+    /// Release a savepoint. The changes since the savepoint will become part of the enclosing transaction
+    virtual QString releaseSavepoint(QString name);
+
+    /// Rollback the changes since the savepoint. The savepoint itself is not released.
+    virtual QString rollbackToSavepoint(QString name);
+
+    /// Create a temporary table of a single column "v" if it is not existed
+    virtual QString createValueTable(QString name);
+
+    /// Insert a value to the temporary table
+    virtual QString insertIntoValueTable(QString name);
+
+    /// Remove all the values from the temporary table
+    virtual QString clearValueTable(QString name);
+
     /// Returns a string representation of the QVariant for SQL statement
     virtual QString formatValue(QVariant value,bool trimStrings = false);
 
@@ -78,12 +119,28 @@ protected:
 
     virtual QString selectCore(DQQueryRules rules);
 
+    /// The "SELECT ... FROM ... WHERE ... GROUP BY ..." part with the result columns
+    virtual QString selectCore(DQQueryRules rules,QString resultColumn);
+
+    /// Select the last record of the window of limit / offset
+    /**
+      The window is read by a subselect , and sorted again in reversed order. The ordering
+      terms are added to the result columns of the subselect as "dq_order_N".
+     */
+    virtual QString reversedWindow(DQQueryRules rules);
+
+    /// Select statement with the tables referenced by DQSharedQuery::selectRelated() joined
+    virtual QString selectRelated(DQQueryRules rules);
+
     virtual QString selectResultColumn(DQQueryRules rules);
 
     virtual QString limitAndOffset(int limit, int offset = 0);
 
     virtual QString orderBy(DQQueryRules rules);
 
+    /// The "GROUP BY ... HAVING ..." clause
+    virtual QString groupBy(DQQueryRules rules,QString having);
+
 };
 
 
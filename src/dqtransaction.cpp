@@ -0,0 +1,74 @@
+#include <QtCore>
+#include <QSharedData>
+
+#include "dqtransaction.h"
+#include "dqconnection.h"
+#include "dqsql.h"
+
+class DQTransactionPriv : public QSharedData {
+public:
+    DQTransactionPriv() {
+        id = -1;
+    }
+
+    ~DQTransactionPriv() {
+        if (id >= 0) {
+            connection.sql().end(id,false);
+        }
+    }
+
+    DQConnection connection;
+
+    /// The id of transaction assigned by DQSql. -1 if it is not active
+    int id;
+};
+
+DQTransaction::DQTransaction() : d(new DQTransactionPriv)
+{
+}
+
+DQTransaction::DQTransaction(DQConnection connection) : d(new DQTransactionPriv)
+{
+    d->connection = connection;
+    d->id = connection.sql().begin();
+}
+
+DQTransaction::DQTransaction(const DQTransaction &other) : d(other.d)
+{
+}
+
+DQTransaction &DQTransaction::operator=(const DQTransaction &rhs)
+{
+    if (this != &rhs)
+        d.operator=(rhs.d);
+    return *this;
+}
+
+DQTransaction::~DQTransaction()
+{
+}
+
+bool DQTransaction::isActive(){
+    if (d->id < 0)
+        return false;
+
+    return d->connection.sql().isActive(d->id);
+}
+
+bool DQTransaction::commit(){
+    if (d->id < 0)
+        return false;
+
+    bool res = d->connection.sql().end(d->id,true);
+    d->id = -1;
+    return res;
+}
+
+bool DQTransaction::rollback(){
+    if (d->id < 0)
+        return false;
+
+    bool res = d->connection.sql().end(d->id,false);
+    d->id = -1;
+    return res;
+}
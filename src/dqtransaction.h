@@ -0,0 +1,74 @@
+#ifndef DQTRANSACTION_H
+#define DQTRANSACTION_H
+
+#include <QExplicitlySharedDataPointer>
+
+class DQConnection;
+class DQTransactionPriv;
+
+/// Transaction scope of a connection
+/**
+  DQTransaction is obtained by DQConnection::transaction(). A transaction is
+  started on construction and it will be rolled back on destruction unless
+  commit() is called. All the operations on the connection (e.g DQModel::save() ,
+  DQModel::remove() , DQQuery::remove()) will join the active transaction
+  automatically.
+
+  If there has an active transaction on the connection, a savepoint is created
+  instead. So transactions could be nested. Commit or rollback of a nested
+  transaction only affect the changes made since it is started. Finishing
+  a transaction will also finish all of its nested transactions.
+
+Example code:
+\code
+
+    DQTransaction transaction = connection.transaction();
+
+    user.save();
+    examResult.save();
+
+    transaction.commit(); // Or it will be rolled back on destruction
+
+\endcode
+
+  @remarks It is an explicitly shared class. The transaction is rolled back when the last reference is destroyed.
+ */
+
+class DQTransaction
+{
+public:
+    /// Constructs a null transaction which is not active
+    DQTransaction();
+
+    /// Constructs a DQTransaction which is the reference to other
+    DQTransaction(const DQTransaction &other);
+
+    /// Refer to other DQTransaction and returns a reference to this DQTransaction
+    DQTransaction &operator=(const DQTransaction &rhs);
+
+    /// Destructor. The transaction is rolled back if it is the last reference and it is still active.
+    ~DQTransaction();
+
+    /// Return TRUE if the transaction is started and not yet finished
+    /**
+      It is FALSE if the transaction could not be started (e.g the database is in a
+      transaction that is not started by DQuest) or it is finished by an enclosing transaction.
+     */
+    bool isActive();
+
+    /// Commit the transaction
+    bool commit();
+
+    /// Rollback the transaction
+    bool rollback();
+
+private:
+    /// Start a transaction on the connection
+    explicit DQTransaction(DQConnection connection);
+
+    QExplicitlySharedDataPointer<DQTransactionPriv> d;
+
+    friend class DQConnection;
+};
+
+#endif // DQTRANSACTION_H
@@ -0,0 +1,49 @@
+#ifndef DQTUPLE_H
+#define DQTUPLE_H
+
+/// The type of unused element of DQTuple
+class DQTupleNull {
+public:
+    bool operator==(const DQTupleNull&) const {
+        return true;
+    }
+};
+
+/// A tuple of 2 to 4 values
+/**
+  It is the row type of DQQuery::values() with multiple fields.
+
+\code
+    QVector<DQTuple<int,QString> > rows = DQQuery<HealthCheck>().values<int,QString>("height","name");
+    foreach (DQTuple<int,QString> row , rows) {
+        qDebug() << row.first << row.second;
+    }
+\endcode
+ */
+
+template <typename T1 , typename T2 , typename T3 = DQTupleNull , typename T4 = DQTupleNull>
+class DQTuple {
+public:
+    DQTuple() : first() , second() , third() , fourth() {
+    }
+
+    DQTuple(const T1& v1 , const T2& v2 , const T3& v3 = T3() , const T4& v4 = T4()) :
+        first(v1) , second(v2) , third(v3) , fourth(v4) {
+    }
+
+    bool operator==(const DQTuple& rhs) const {
+        return first == rhs.first && second == rhs.second &&
+               third == rhs.third && fourth == rhs.fourth;
+    }
+
+    bool operator!=(const DQTuple& rhs) const {
+        return !(*this == rhs);
+    }
+
+    T1 first;
+    T2 second;
+    T3 third;
+    T4 fourth;
+};
+
+#endif // DQTUPLE_H
@@ -3,6 +3,10 @@
 
 /* DQuest general header file*/
 #include <dqmodel.h>
+#include <dqconnectionpool.h>
+#include <dqasync.h>
+#include <dqpreparedquery.h>
+#include <dqtransaction.h>
 #include <dqlistwriter.h>
 #include <dqstream.h>
 
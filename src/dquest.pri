@@ -9,6 +9,9 @@ DQUEST_HEADERS += \
     $$PWD/dqmodelmetainfo.h \
     $$PWD/dqmodel.h \
     $$PWD/dqconnection.h \
+    $$PWD/dqconnectionpool.h \
+    $$PWD/dqasync.h \
+    $$PWD/dqtransaction.h \
     $$PWD/dqbasefield.h \
     $$PWD/dqsqlstatement.h \
     $$PWD/dqsqlitestatement.h \
@@ -18,6 +21,13 @@ DQUEST_HEADERS += \
     $$PWD/dqforeignkey.h \
     $$PWD/dqsharedquery.h \
     $$PWD/dqquery.h \
+    $$PWD/dqcursor.h \
+    $$PWD/dqquerystream.h \
+    $$PWD/dqpaginator.h \
+    $$PWD/dqtuple.h \
+    $$PWD/dqcolumnset.h \
+    $$PWD/dqaggregate.h \
+    $$PWD/dqpreparedquery.h \
     $$PWD/dqqueryrules.h \
     $$PWD/dqexpression.h \
     $$PWD/dqlist.h \
@@ -31,6 +41,7 @@ DQUEST_HEADERS += \
 DQUEST_PRIV_HEADERS = \
     $$PWD/dqwhere_p.h \
     $$PWD/dqsharedquery_p.h \
+    $$PWD/dqasync_p.h \
     $$PWD/dqmetainfoquery_p.h
 
 HEADERS += $$DQUEST_HEADERS
@@ -41,6 +52,9 @@ SOURCES += \
     $$PWD/dqmodelmetainfo.cpp \
     $$PWD/dqmodel.cpp \
     $$PWD/dqconnection.cpp \
+    $$PWD/dqconnectionpool.cpp \
+    $$PWD/dqasync.cpp \
+    $$PWD/dqtransaction.cpp \
     $$PWD/dqbasefield.cpp \
     $$PWD/dqsqlstatement.cpp \
     $$PWD/dqsqlitestatement.cpp \
@@ -48,6 +62,10 @@ SOURCES += \
     $$PWD/dqsql.cpp \
     $$PWD/dqfield.cpp \
     $$PWD/dqsharedquery.cpp \
+    $$PWD/dqquerystream.cpp \
+    $$PWD/dqpaginator.cpp \
+    $$PWD/dqcolumnset.cpp \
+    $$PWD/dqpreparedquery.cpp \
     $$PWD/dqqueryrules.cpp \
     $$PWD/dqexpression.cpp \
     $$PWD/dqabstractmodel.cpp \
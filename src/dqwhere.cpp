@@ -1,6 +1,8 @@
 #include <QtCore>
 #include "dqwhere.h"
 #include "dqwhere_p.h"
+#include "dqsharedquery.h"
+#include "dqqueryrules.h"
 
 /* Test cases:
 
@@ -121,6 +123,11 @@ QString DQWhere::toString() {
         return variantToString(m_left,false);
     }
 
+    if (!m_left.isValid() && m_right.isValid()) {
+        // exists() does not have left operand
+        return QString("%1 %2").arg(m_op).arg(variantToString(m_right,true));
+    }
+
     if (m_left.isNull() || m_right.isNull())
         return "";
 
@@ -217,11 +224,11 @@ DQWhere DQWhere::operator!=(QVariant right){
 }
 
 DQWhere DQWhere::operator+(QVariant right){
-    return expr("*",right);
+    return expr("+",right);
 }
 
 DQWhere DQWhere::operator-(QVariant right){
-    return expr("*",right);
+    return expr("-",right);
 }
 
 DQWhere DQWhere::operator*(QVariant right){
@@ -271,6 +278,49 @@ DQWhere DQWhere::notIn (QList<QVariant> list) {
     return expr("not in",v);
 }
 
+/// Wrap the query as the operand of subselect
+static QVariant subquery(DQSharedQuery query , bool selectId) {
+    if (selectId) {
+        DQQueryRules rules;
+        rules = query;
+        if (rules.fields().isEmpty())
+            query = query.select("id");
+    }
+
+    QVariant q;
+    q.setValue<DQSharedQuery>(query);
+
+    DQWhereDataPriv data(DQWhereDataPriv::Subquery);
+    data << q;
+    QVariant v;
+    v.setValue<DQWhereDataPriv>(data);
+    return v;
+}
+
+DQWhere DQWhere::in(const DQSharedQuery& query){
+    return expr("in",subquery(query,true));
+}
+
+DQWhere DQWhere::notIn(const DQSharedQuery& query){
+    return expr("not in",subquery(query,true));
+}
+
+DQWhere DQWhere::exists(const DQSharedQuery& query){
+    DQWhere w;
+
+    w.m_right = subquery(query,false);
+    w.m_op = "exists";
+    w.m_isNull = false;
+
+    return w;
+}
+
+DQWhere DQWhere::notExists(const DQSharedQuery& query){
+    DQWhere w = exists(query);
+    w.m_op = "not exists";
+    return w;
+}
+
 DQWhere DQWhere::like (QVariant other){
     return expr("like",other);
 }
@@ -293,6 +343,22 @@ DQWhere::operator QVariant() const{
     return v;
 }
 
+DQParam::DQParam(){
+}
+
+DQParam::DQParam(QString name) : m_name(name){
+}
+
+QString DQParam::name() const {
+    return m_name;
+}
+
+DQParam::operator QVariant() const{
+    QVariant v;
+    v.setValue<DQParam>(*this);
+    return v;
+}
+
 QString variantToString(QVariant v,bool quoteString){
     QString res;
     /// @todo Implement QVariant::convert()
@@ -311,6 +377,8 @@ QString variantToString(QVariant v,bool quoteString){
         DQWhereFieldPriv f;
         f = v.value<DQWhereFieldPriv>();
         res = f;
+    } else if (v.userType() == qMetaTypeId<DQParam>()) {
+        res = ":" + v.value<DQParam>().name();
     } else if (v.type() == QVariant::String
                && quoteString) {
         res = QString("\"%1\"").arg(v.toString());
@@ -3,6 +3,8 @@
 
 #include <QVariant>
 
+class DQSharedQuery;
+
 /// The filter rules
 /**
    The DQWhere object represent an expression / rules in query for filter the result
@@ -174,11 +176,43 @@ public:
     DQWhere between(QVariant v1,QVariant v2);
 
     /// Return a DQWhere object which is the expression of "this in (list)"
+    /**
+      If the list is larger than DQExpression::valueTableThreshold() , the values are
+      written to a temporary table of the connection and the query is executed as
+      "this in (SELECT v FROM table)". The statement is then in fixed size no matter how
+      long the list is.
+
+      @remarks The temporary table is refilled by every query with large list on the connection.
+      Consume the result of a query before executing the next one.
+     */
     DQWhere in (QList<QVariant> list);
 
     /// Return a DQWhere object which is the expression of "this not in (list)"
+    /**
+      @see in()
+     */
     DQWhere notIn (QList<QVariant> list);
 
+    /// Return a DQWhere object which is the expression of "this in (subselect)"
+    /**
+      The query is executed as a subselect within the same statement. Its filter
+      is bound together with the outer query. If no field is selected by the query ,
+      "id" is used.
+
+\code
+    // Users who have any exam result of mark > 80
+    DQQuery<User> query = DQQuery<User>().filter(
+        DQWhere("id").in(DQQuery<ExamResult>().filter(DQWhere("mark") > 80).select("uid")));
+\endcode
+     */
+    DQWhere in (const DQSharedQuery& query);
+
+    /// Return a DQWhere object which is the expression of "this not in (subselect)"
+    /**
+      @see in(const DQSharedQuery&)
+     */
+    DQWhere notIn (const DQSharedQuery& query);
+
     /// Return a DQWhere object which is the expression of "this" "like"  "v"
     DQWhere like (QVariant other);
 
@@ -194,6 +228,22 @@ public:
     /// Cast the object to QVariant type
     operator QVariant() const;
 
+    /// Return a DQWhere object which is the expression of "exists (subselect)"
+    /**
+      The subselect could be correlated with the outer query by a field qualified
+      with the table name:
+
+\code
+    // Users who have any exam result
+    DQQuery<User> query = DQQuery<User>().filter(
+        DQWhere::exists(DQQuery<ExamResult>().filter(DQWhere("uid") == DQWhere("user.id"))));
+\endcode
+     */
+    static DQWhere exists(const DQSharedQuery& query);
+
+    /// Return a DQWhere object which is the expression of "not exists (subselect)"
+    static DQWhere notExists(const DQSharedQuery& query);
+
 private:
     /// left Operand
     QVariant m_left;
@@ -211,4 +261,38 @@ private:
 
 Q_DECLARE_METATYPE(DQWhere)
 
+/// A named parameter in DQWhere expression
+/**
+  The value of the parameter is not known when the expression is built. It is
+  assigned by DQPreparedQuery::bind() on every execution.
+
+\code
+    DQPreparedQuery<User> query(DQQuery<User>().filter(DQWhere("userId") == DQParam("uid")));
+    DQList<User> users = query.bind("uid","tester").all();
+\endcode
+
+  @remarks The name should only contain letters , digits and underscore.
+  @see DQPreparedQuery
+ */
+
+class DQParam {
+public:
+    /// Construct a null parameter
+    DQParam();
+
+    /// Construct a parameter with the name
+    explicit DQParam(QString name);
+
+    /// The name of parameter
+    QString name() const;
+
+    /// Cast the object to QVariant type
+    operator QVariant() const;
+
+private:
+    QString m_name;
+};
+
+Q_DECLARE_METATYPE(DQParam)
+
 #endif // DQWHERE_H
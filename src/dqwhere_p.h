@@ -13,7 +13,9 @@ public:
     enum Type {
         None,
         In,
-        Between
+        Between,
+        /// A DQSharedQuery as subselect
+        Subquery
     };
 
     DQWhereDataPriv();
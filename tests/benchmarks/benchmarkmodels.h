@@ -0,0 +1,50 @@
+#ifndef BENCHMARKMODELS_H
+#define BENCHMARKMODELS_H
+
+#include <dqmodel.h>
+
+/* 200 models for the benchmark of model registration */
+
+#define BENCHMARK_MODEL(N) \
+    class BenchmarkModel##N : public DQModel { \
+        DQ_MODEL \
+    public: \
+        DQField<QString> name; \
+        DQField<int> value; \
+        DQField<double> weight; \
+        DQField<QDateTime> lastModifiedTime; \
+    }; \
+    DQ_DECLARE_MODEL(BenchmarkModel##N, \
+                     "benchmarkmodel" #N, \
+                     DQ_FIELD(name , DQNotNull), \
+                     DQ_FIELD(value), \
+                     DQ_FIELD(weight), \
+                     DQ_FIELD(lastModifiedTime) \
+                     );
+
+#define BENCHMARK_MODEL_10(N) \
+    BENCHMARK_MODEL(N##0) BENCHMARK_MODEL(N##1) BENCHMARK_MODEL(N##2) BENCHMARK_MODEL(N##3) BENCHMARK_MODEL(N##4) \
+    BENCHMARK_MODEL(N##5) BENCHMARK_MODEL(N##6) BENCHMARK_MODEL(N##7) BENCHMARK_MODEL(N##8) BENCHMARK_MODEL(N##9)
+
+BENCHMARK_MODEL_10(1) BENCHMARK_MODEL_10(2) BENCHMARK_MODEL_10(3) BENCHMARK_MODEL_10(4) BENCHMARK_MODEL_10(5)
+BENCHMARK_MODEL_10(6) BENCHMARK_MODEL_10(7) BENCHMARK_MODEL_10(8) BENCHMARK_MODEL_10(9) BENCHMARK_MODEL_10(10)
+BENCHMARK_MODEL_10(11) BENCHMARK_MODEL_10(12) BENCHMARK_MODEL_10(13) BENCHMARK_MODEL_10(14) BENCHMARK_MODEL_10(15)
+BENCHMARK_MODEL_10(16) BENCHMARK_MODEL_10(17) BENCHMARK_MODEL_10(18) BENCHMARK_MODEL_10(19) BENCHMARK_MODEL_10(20)
+
+#define BENCHMARK_META_INFO(N) dqMetaInfo<BenchmarkModel##N>();
+
+#define BENCHMARK_META_INFO_10(N) \
+    BENCHMARK_META_INFO(N##0) BENCHMARK_META_INFO(N##1) BENCHMARK_META_INFO(N##2) BENCHMARK_META_INFO(N##3) \
+    BENCHMARK_META_INFO(N##4) BENCHMARK_META_INFO(N##5) BENCHMARK_META_INFO(N##6) BENCHMARK_META_INFO(N##7) \
+    BENCHMARK_META_INFO(N##8) BENCHMARK_META_INFO(N##9)
+
+/// Create the meta info of all the benchmark models
+inline void registerBenchmarkModels() {
+    BENCHMARK_META_INFO_10(1) BENCHMARK_META_INFO_10(2) BENCHMARK_META_INFO_10(3) BENCHMARK_META_INFO_10(4)
+    BENCHMARK_META_INFO_10(5) BENCHMARK_META_INFO_10(6) BENCHMARK_META_INFO_10(7) BENCHMARK_META_INFO_10(8)
+    BENCHMARK_META_INFO_10(9) BENCHMARK_META_INFO_10(10) BENCHMARK_META_INFO_10(11) BENCHMARK_META_INFO_10(12)
+    BENCHMARK_META_INFO_10(13) BENCHMARK_META_INFO_10(14) BENCHMARK_META_INFO_10(15) BENCHMARK_META_INFO_10(16)
+    BENCHMARK_META_INFO_10(17) BENCHMARK_META_INFO_10(18) BENCHMARK_META_INFO_10(19) BENCHMARK_META_INFO_10(20)
+}
+
+#endif // BENCHMARKMODELS_H
@@ -0,0 +1,26 @@
+#-------------------------------------------------
+#
+# Performance benchmarks of DQuest
+#
+#-------------------------------------------------
+
+QT       += core
+QT       += testlib
+QT       -= gui
+
+TARGET = benchmarks
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+
+SOURCES += main.cpp \
+    benchmarktests.cpp
+
+HEADERS += \
+    benchmarktests.h \
+    benchmarkmodels.h
+
+include (../../src/dquest.pri)
+include(../models/models.pri)
@@ -0,0 +1,949 @@
+#include <QThreadPool>
+#include <QRunnable>
+#include <QFile>
+#include <QSqlRecord>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QSemaphore>
+#include "benchmarktests.h"
+#include "benchmarkmodels.h"
+
+#include <new>
+#include <stdlib.h>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+/// No. of heap allocation by operator new
+static QAtomicInt allocationCount;
+
+#if __cplusplus >= 201103L
+void* operator new(size_t size) {
+#else
+void* operator new(size_t size) throw (std::bad_alloc) {
+#endif
+    allocationCount.ref();
+    void *p = malloc(size > 0 ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) throw() {
+    free(p);
+}
+
+/// No. of records inserted by initTestCase()
+static const int InitialRecordCount = 1000;
+
+/// No. of users inserted by initTestCase()
+static const int InitialUserCount = 100;
+
+/// No. of records inserted by cursor()
+static const int CursorRecordCount = 1000000;
+
+/// No. of records per page in pagination()
+static const int PaginationPageSize = 100;
+
+/// The peak resident set size of the process in KB. Return -1 if it is not supported.
+static long peakRss() {
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF,&usage) == 0)
+        return usage.ru_maxrss;
+#endif
+    return -1;
+}
+
+/// Insert no. of HealthCheck records with the name by a single statement
+static bool insertHealthChecks(QSqlDatabase db,QString name,int count) {
+    QSqlQuery q(db);
+    bool res = q.exec(QString("WITH RECURSIVE seq(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM seq WHERE x < %1) "
+                              "INSERT INTO healthcheck (name,height,weight) SELECT '%2' , x % 200 , x % 100 FROM seq")
+                      .arg(count).arg(name));
+    q.finish();
+    return res;
+}
+
+/// The interval of the timer of LatencyProbe in ms
+static const int LatencyTimerInterval = 10;
+
+LatencyProbe::LatencyProbe(QObject* parent) : QObject(parent) , m_maxInterval(0)
+{
+}
+
+qint64 LatencyProbe::maxInterval() const {
+    return m_maxInterval;
+}
+
+void LatencyProbe::start(){
+    m_maxInterval = 0;
+    m_timer.start();
+}
+
+void LatencyProbe::tick(){
+    m_maxInterval = qMax(m_maxInterval,m_timer.restart());
+}
+
+BenchmarkTests::BenchmarkTests(QObject* parent) : QObject(parent)
+{
+}
+
+void BenchmarkTests::initTestCase()
+{
+    QFile::remove("benchmark.db");
+
+    db = QSqlDatabase::addDatabase("QSQLITE","benchmark");
+    db.setDatabaseName( "benchmark.db" );
+    db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=10000");
+
+    QVERIFY( db.open() );
+
+    QSqlQuery q(db);
+    QVERIFY(q.exec("PRAGMA journal_mode=WAL"));
+    q.finish();
+
+    QVERIFY (connect.open(db) );
+    QVERIFY ( connect.addModel<HealthCheck>());
+    QVERIFY ( connect.addModel<User>());
+    QVERIFY ( connect.addModel<ExamResult>());
+
+    QVERIFY( connect.dropTables() );
+    QVERIFY( connect.createTables() );
+
+    QVERIFY(connect.sql().database().transaction());
+    for (int i = 0 ; i < InitialRecordCount;i++) {
+        HealthCheck record;
+        record.name = QString("record %1").arg(i);
+        record.height = i % 200;
+        record.weight = i % 100;
+        record.recordDate = QDate::currentDate();
+        QVERIFY(record.save());
+    }
+
+    DQList<User> users;
+    for (int i = 0 ; i < InitialUserCount;i++) {
+        User *user = new User();
+        user->userId = QString("user%1").arg(i);
+        user->name = QString("User %1").arg(i);
+        user->passwd = "12345678";
+        users.append(user);
+    }
+    QVERIFY(users.save());
+
+    DQList<ExamResult> results;
+    for (int i = 0 ; i < InitialRecordCount;i++) {
+        ExamResult *result = new ExamResult();
+        result->uid = users.at(i % InitialUserCount)->id();
+        result->subject = "Maths";
+        result->mark = i % 100;
+        results.append(result);
+    }
+    QVERIFY(results.save());
+    QVERIFY(connect.sql().database().commit());
+
+    DQIndex<HealthCheck> index("healthcheck_name_height");
+    index << "name" << "height";
+    QVERIFY(connect.createIndex(index));
+
+    DQIndex<HealthCheck> dateIndex("healthcheck_recordDate");
+    dateIndex << "recordDate";
+    QVERIFY(connect.createIndex(dateIndex));
+}
+
+void BenchmarkTests::cleanupTestCase()
+{
+    connect.close();
+}
+
+/// A task that read or write HealthCheck via the default connection
+class ConnectionPoolTask : public QRunnable {
+public:
+    ConnectionPoolTask(bool write , int loop) : write(write) , loop(loop) {
+    }
+
+    void run() {
+        for (int i = 0 ; i < loop ; i++) {
+            if (write) {
+                HealthCheck record;
+                record.name = "pool";
+                record.height = i;
+                record.weight = i;
+                record.save();
+            } else {
+                DQQuery<HealthCheck> query;
+                query.filter(DQWhere("height") == i % 200).count();
+            }
+        }
+    }
+
+    bool write;
+    int loop;
+};
+
+/// A task that clone the connection of default pool , and hold the thread until all the threads are started
+class ConnectionPoolWarmUpTask : public QRunnable {
+public:
+    ConnectionPoolWarmUpTask(QSemaphore *started , QSemaphore *finish) : started(started) , finish(finish) {
+    }
+
+    void run() {
+        DQConnection::defaultConnection();
+        started->release();
+        finish->acquire();
+    }
+
+    QSemaphore *started;
+    QSemaphore *finish;
+};
+
+void BenchmarkTests::connectionPool_data(){
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<bool>("write");
+
+    int max = qMax(QThread::idealThreadCount(),1);
+
+    for (int i = 1 ; i <= max ; i *= 2) {
+        QTest::newRow(QString("read-%1").arg(i).toLatin1().constData()) << i << false;
+        QTest::newRow(QString("write-%1").arg(i).toLatin1().constData()) << i << true;
+    }
+}
+
+void BenchmarkTests::connectionPool(){
+    QFETCH(int,threads);
+    QFETCH(bool,write);
+
+    const int loop = 200;
+
+    DQConnectionPool pool;
+    QVERIFY(pool.open(connect));
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threads);
+    threadPool.setExpiryTimeout(-1);
+
+    // Create the worker threads and their thread-local connection before QBENCHMARK
+    QSemaphore started,finish;
+    for (int i = 0 ; i < threads ; i++) {
+        threadPool.start(new ConnectionPoolWarmUpTask(&started,&finish));
+    }
+    started.acquire(threads);
+    finish.release(threads);
+    threadPool.waitForDone();
+
+    QBENCHMARK {
+        for (int i = 0 ; i < threads ; i++) {
+            threadPool.start(new ConnectionPoolTask(write,loop));
+        }
+        threadPool.waitForDone();
+    }
+
+    threadPool.waitForDone();
+}
+
+void BenchmarkTests::statementCache_data(){
+    QTest::addColumn<int>("capacity");
+
+    QTest::newRow("disabled") << 0;
+    QTest::newRow("enabled") << 64;
+}
+
+void BenchmarkTests::statementCache(){
+    QFETCH(int,capacity);
+
+    int origCapacity = connect.statementCacheCapacity();
+    connect.setStatementCacheCapacity(capacity);
+
+    QVERIFY(connect.sql().database().transaction());
+
+    QBENCHMARK {
+        for (int i = 0 ; i < 100;i++) {
+            HealthCheck record;
+            record.name = "cache";
+            record.height = i;
+            record.save();
+
+            HealthCheck loaded;
+            loaded.load(DQWhere("id = " , record.id));
+        }
+    }
+
+    QVERIFY(connect.sql().database().rollback());
+
+    connect.setStatementCacheCapacity(origCapacity);
+}
+
+void BenchmarkTests::bulkSave_data(){
+    QTest::addColumn<int>("chunkSize");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("all") << 0;
+}
+
+void BenchmarkTests::bulkSave(){
+    QFETCH(int,chunkSize);
+
+    DQList<HealthCheck> records;
+    records.setSaveChunkSize(chunkSize);
+
+    for (int i = 0 ; i < 1000;i++) {
+        HealthCheck* record = new HealthCheck();
+        record->name = "bulk";
+        record->height = i;
+        record->weight = i;
+        records.append(record);
+    }
+
+    QBENCHMARK {
+        QVERIFY(records.save(true));
+    }
+
+    DQQuery<HealthCheck> query;
+    QVERIFY(query.filter(DQWhere("name = " , "bulk")).remove());
+}
+
+void BenchmarkTests::updateModified_data(){
+    QTest::addColumn<bool>("replace");
+
+    QTest::newRow("update") << false;
+    QTest::newRow("replace") << true;
+}
+
+void BenchmarkTests::updateModified(){
+    QFETCH(bool,replace);
+
+    DQList<HealthCheck> records = DQQuery<HealthCheck>().limit(500).all();
+    QVERIFY(records.size() > 0);
+    int n = records.size();
+    int weight = 0;
+
+    QBENCHMARK {
+        DQTransaction transaction = connect.transaction();
+        weight++;
+        for (int i = 0 ; i < n;i++) {
+            HealthCheck *record = records.at(i);
+            record->weight = weight;
+            if (replace) {
+                record->id.setModified(true); // Take the original REPLACE path
+            }
+            record->save();
+        }
+        transaction.commit();
+    }
+}
+
+void BenchmarkTests::prefetch_data(){
+    QTest::addColumn<QString>("mode");
+
+    QTest::newRow("lazy") << "lazy";
+    QTest::newRow("prefetch") << "prefetch";
+    QTest::newRow("selectRelated") << "selectRelated";
+}
+
+void BenchmarkTests::prefetch(){
+    QFETCH(QString,mode);
+
+    QBENCHMARK {
+        DQQuery<ExamResult> query;
+        if (mode == "prefetch")
+            query = query.prefetch("uid");
+        else if (mode == "selectRelated")
+            query = query.selectRelated("uid");
+
+        DQList<ExamResult> results = query.all();
+        int n = results.size();
+        for (int i = 0 ; i < n;i++) {
+            results.at(i)->uid->name;
+        }
+    }
+}
+
+void BenchmarkTests::cursor_data(){
+    QTest::addColumn<bool>("iterate");
+
+    // The peak RSS never goes down. The cursor must be measured first.
+    QTest::newRow("iterate") << true;
+    QTest::newRow("all") << false;
+}
+
+void BenchmarkTests::cursor(){
+    QFETCH(bool,iterate);
+
+    QVERIFY(insertHealthChecks(connect.sql().database(),"cursor",CursorRecordCount));
+
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().filter(DQWhere("name") == "cursor");
+    long before = peakRss();
+    int count = 0;
+
+    QBENCHMARK_ONCE {
+        if (iterate) {
+            DQCursor<HealthCheck> cursor = query.iterate();
+            for (DQCursor<HealthCheck>::iterator iter = cursor.begin() ; iter != cursor.end() ; ++iter) {
+                count++;
+            }
+        } else {
+            DQList<HealthCheck> list = query.all();
+            count = list.size();
+        }
+    }
+
+    long after = peakRss();
+
+    QVERIFY(count == CursorRecordCount);
+    qDebug() << QString("Peak RSS : %1 KB (+%2 KB)").arg(after).arg(after - before);
+
+    QVERIFY(query.remove());
+}
+
+void BenchmarkTests::hydrate_data(){
+    QTest::addColumn<bool>("byIndex");
+
+    QTest::newRow("byName") << false;
+    QTest::newRow("byIndex") << true;
+}
+
+void BenchmarkTests::hydrate(){
+    QFETCH(bool,byIndex);
+
+    DQModelMetaInfo *metaInfo = dqMetaInfo<HealthCheck>();
+    DQQuery<HealthCheck> query;
+    HealthCheck record;
+    qint64 rows = 0;
+    QElapsedTimer timer;
+    timer.start();
+
+    QBENCHMARK {
+        QVERIFY(query.exec());
+        QSqlQuery q = query.lastQuery();
+        while (query.next()) {
+            if (byIndex) {
+                query.recordTo(record);
+            } else {
+                // The lookup by name on every cell
+                QSqlRecord r = q.record();
+                int count = r.count();
+                for (int i = 0 ; i < count;i++) {
+                    metaInfo->setValue(&record,r.fieldName(i),r.value(i));
+                }
+                metaInfo->setModified(&record,false);
+            }
+            rows++;
+        }
+        query.finish();
+    }
+
+    qint64 elapsed = timer.elapsed();
+    if (elapsed > 0)
+        qDebug() << QString("%1 rows/sec").arg(rows * 1000 / elapsed);
+}
+
+void BenchmarkTests::arena_data(){
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("arena");
+
+    int counts[] = {10000,100000,1000000};
+
+    for (int i = 0 ; i < 3;i++) {
+        QTest::newRow(QString("heap-%1").arg(counts[i]).toLatin1().constData()) << counts[i] << false;
+        QTest::newRow(QString("arena-%1").arg(counts[i]).toLatin1().constData()) << counts[i] << true;
+    }
+}
+
+void BenchmarkTests::arena(){
+    QFETCH(int,count);
+    QFETCH(bool,arena);
+
+    QVERIFY(insertHealthChecks(connect.sql().database(),"arena",count));
+
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().filter(DQWhere("name") == "arena").useArena(arena);
+    int size = 0;
+    int allocations = 0;
+
+    QBENCHMARK {
+        int before = allocationCount;
+        DQList<HealthCheck> list = query.all();
+        size = list.size();
+        allocations = allocationCount - before;
+        list.clear();
+    }
+
+    QVERIFY(size == count);
+    qDebug() << QString("%1 heap allocations (%2 per record)").arg(allocations).arg((double) allocations / count);
+
+    QVERIFY(query.remove());
+}
+
+void BenchmarkTests::fieldAccess_data(){
+    QTest::addColumn<QString>("model");
+    QTest::addColumn<bool>("typed");
+
+    QTest::newRow("HealthCheck-variant") << "HealthCheck" << false;
+    QTest::newRow("HealthCheck-typed") << "HealthCheck" << true;
+    QTest::newRow("AllType-variant") << "AllType" << false;
+    QTest::newRow("AllType-typed") << "AllType" << true;
+}
+
+void BenchmarkTests::fieldAccess(){
+    QFETCH(QString,model);
+    QFETCH(bool,typed);
+
+    const int loop = 100000;
+    double sum = 0;
+
+    HealthCheck record;
+    record.name = "field";
+    record.height = 170;
+    record.weight = 60.5;
+    record.recordDate = QDate::currentDate();
+
+    AllType type;
+    type.string = "field";
+    type.integer = 1;
+    type.d = 2.0;
+    type.real = 3.0;
+    type.b = true;
+
+    if (model == "HealthCheck") {
+        qDebug() << QString("%1 bytes per row").arg(record.metaInfo()->objectSize());
+
+        QBENCHMARK {
+            for (int i = 0 ; i < loop;i++) {
+                if (typed) {
+                    sum += record.height.value() + record.weight.value() + record.name.value().size();
+                } else {
+                    sum += record.height.get().toInt() + record.weight.get().toDouble() + record.name.get().toString().size();
+                }
+            }
+        }
+    } else {
+        qDebug() << QString("%1 bytes per row").arg(type.metaInfo()->objectSize());
+
+        QBENCHMARK {
+            for (int i = 0 ; i < loop;i++) {
+                if (typed) {
+                    sum += type.integer.value() + type.d.value() + type.real.value() + type.b.value() + type.string.value().size();
+                } else {
+                    sum += type.integer.get().toInt() + type.d.get().toDouble() + type.real.get().toDouble() +
+                           type.b.get().toBool() + type.string.get().toString().size();
+                }
+            }
+        }
+    }
+
+    QVERIFY(sum > 0);
+}
+
+void BenchmarkTests::metaInfoRegistration(){
+    // The meta info is created once per model. Only the first run is measured.
+    QBENCHMARK_ONCE {
+        registerBenchmarkModels();
+    }
+
+    QVERIFY(dqMetaInfo<BenchmarkModel209>()->size() == 5);
+    QVERIFY(dqMetaInfo<BenchmarkModel209>()->name() == "benchmarkmodel209");
+}
+
+void BenchmarkTests::latency_data(){
+    QTest::addColumn<bool>("async");
+
+    QTest::newRow("all") << false;
+    QTest::newRow("allAsync") << true;
+}
+
+void BenchmarkTests::latency(){
+    QFETCH(bool,async);
+
+    QVERIFY(insertHealthChecks(connect.sql().database(),"latency",CursorRecordCount));
+
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().filter(DQWhere("name") == "latency");
+    LatencyProbe probe;
+    QTimer timer;
+    QObject::connect(&timer,SIGNAL(timeout()),&probe,SLOT(tick()));
+    timer.start(LatencyTimerInterval);
+    int count = 0;
+
+    QBENCHMARK_ONCE {
+        probe.start();
+        if (async) {
+            QEventLoop loop;
+            QFutureWatcher<DQSharedList> watcher;
+            QObject::connect(&watcher,SIGNAL(finished()),&loop,SLOT(quit()));
+            watcher.setFuture(query.allAsync());
+            loop.exec();
+            count = watcher.result().size();
+        } else {
+            count = query.all().size();
+        }
+        // Deliver the pending timer event
+        QCoreApplication::processEvents();
+    }
+
+    timer.stop();
+
+    QVERIFY(count == CursorRecordCount);
+    qDebug() << QString("Max. event loop latency : %1 ms (timer interval %2 ms)")
+                .arg(probe.maxInterval()).arg(LatencyTimerInterval);
+
+    QVERIFY(query.remove());
+}
+
+void BenchmarkTests::pagination_data(){
+    QTest::addColumn<bool>("keyset");
+    QTest::addColumn<int>("page");
+    QTest::addColumn<QString>("orderField");
+
+    QTest::newRow("offset page 1") << false << 1 << "id";
+    QTest::newRow("keyset page 1") << true << 1 << "id";
+    QTest::newRow("offset page 10000") << false << 10000 << "id";
+    QTest::newRow("keyset page 10000") << true << 10000 << "id";
+
+    // Sorted by the indexed "height" with duplicated values. The "id" is the tie-breaker.
+    QTest::newRow("offset page 1 by height") << false << 1 << "height";
+    QTest::newRow("keyset page 1 by height") << true << 1 << "height";
+    QTest::newRow("offset page 10000 by height") << false << 10000 << "height";
+    QTest::newRow("keyset page 10000 by height") << true << 10000 << "height";
+}
+
+void BenchmarkTests::pagination(){
+    QFETCH(bool,keyset);
+    QFETCH(int,page);
+    QFETCH(QString,orderField);
+
+    QVERIFY(insertHealthChecks(connect.sql().database(),"pagination",CursorRecordCount));
+
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().filter(DQWhere("name") == "pagination");
+    QStringList terms;
+    terms << orderField;
+    if (orderField != "id")
+        terms << "id";
+
+    int skip = (page - 1) * PaginationPageSize;
+    int count = 0;
+
+    if (keyset) {
+        DQPaginator<HealthCheck> paginator = query.paginate(PaginationPageSize,orderField);
+
+        // The key of the last record of previous page
+        if (skip > 0) {
+            DQList<HealthCheck> previous = query.orderBy(terms).offset(skip - 1).limit(1).all();
+            QVERIFY(previous.size() == 1);
+            if (orderField == "id")
+                paginator.seek(previous.at(0)->id());
+            else
+                paginator.seek(previous.at(0)->height(),previous.at(0)->id());
+        }
+
+        QVariant key = paginator.lastKey();
+        QVariant id = paginator.lastId();
+
+        QBENCHMARK {
+            paginator.seek(key,id);
+            count = paginator.nextPage().size();
+        }
+    } else {
+        QBENCHMARK {
+            count = query.orderBy(terms).limit(PaginationPageSize).offset(skip).all().size();
+        }
+    }
+
+    QVERIFY(count == PaginationPageSize);
+
+    QVERIFY(query.remove());
+}
+
+void BenchmarkTests::projection_data(){
+    QTest::addColumn<bool>("tuple");
+
+    QTest::newRow("select") << false;
+    QTest::newRow("values") << true;
+}
+
+void BenchmarkTests::projection(){
+    QFETCH(bool,tuple);
+
+    const int count = 100000;
+    QVERIFY(insertHealthChecks(connect.sql().database(),"projection",count));
+
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().filter(DQWhere("name") == "projection");
+    qint64 sum = 0;
+    int allocations = 0;
+
+    QBENCHMARK {
+        int before = allocationCount;
+        sum = 0;
+        if (tuple) {
+            QVector<DQTuple<int,QString> > rows = query.values<int,QString>("height","name");
+            for (int i = 0 ; i < rows.size();i++) {
+                sum += rows.at(i).first;
+            }
+        } else {
+            DQList<HealthCheck> list = query.select(QStringList() << "height" << "name").all();
+            for (int i = 0 ; i < list.size();i++) {
+                sum += list.at(i)->height.value();
+            }
+        }
+        allocations = allocationCount - before;
+    }
+
+    QVERIFY(sum > 0);
+    qDebug() << QString("%1 heap allocations (%2 per record)").arg(allocations).arg((double) allocations / count);
+
+    QVERIFY(query.remove());
+}
+
+void BenchmarkTests::columnScan_data(){
+    QTest::addColumn<bool>("columnar");
+
+    QTest::newRow("all") << false;
+    QTest::newRow("columns") << true;
+}
+
+void BenchmarkTests::columnScan(){
+    QFETCH(bool,columnar);
+
+    const int count = 100000;
+    QVERIFY(insertHealthChecks(connect.sql().database(),"columnScan",count));
+
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().filter(DQWhere("name") == "columnScan");
+    double mean = 0;
+    QVector<int> histogram;
+
+    QBENCHMARK {
+        if (columnar) {
+            DQColumnSet set = query.columns(QStringList() << "height" << "weight");
+            mean = set.column("height").mean();
+            histogram = set.column("weight").histogram(10,0,100);
+        } else {
+            DQList<HealthCheck> list = query.all();
+            double sum = 0;
+            histogram = QVector<int>(10,0);
+            for (int i = 0 ; i < list.size();i++) {
+                sum += list.at(i)->height.value();
+                int bin = qMin((int) (list.at(i)->weight.value() / 10),9);
+                histogram[bin]++;
+            }
+            mean = sum / list.size();
+        }
+    }
+
+    QVERIFY(mean > 0);
+    QVERIFY(histogram.size() == 10);
+
+    // The scan over the columns only
+    DQColumnSet set = query.columns(QStringList() << "height" << "weight");
+    QElapsedTimer timer;
+    timer.start();
+    const int loop = 100;
+    double sum = 0;
+    for (int i = 0 ; i < loop;i++) {
+        sum += set.column("height").sum() + set.column("weight").sum();
+    }
+    qint64 elapsed = timer.nsecsElapsed();
+    if (elapsed > 0) {
+        qint64 bytes = (qint64) loop * count * (sizeof(int) + sizeof(double));
+        qDebug() << QString("Column scan : %1 MB/s").arg(bytes * 1000.0 / elapsed,0,'f',0);
+    }
+    QVERIFY(sum > 0);
+
+    QVERIFY(query.remove());
+}
+
+void BenchmarkTests::sqlCache_data(){
+    QTest::addColumn<int>("capacity");
+
+    QTest::newRow("disabled") << 0;
+    QTest::newRow("enabled") << 256;
+}
+
+void BenchmarkTests::sqlCache(){
+    QFETCH(int,capacity);
+
+    DQSql sql = connect.sql();
+    int origCapacity = sql.sqlCacheCapacity();
+    sql.setSqlCacheCapacity(capacity);
+
+    DQQuery<HealthCheck> query;
+    int total = 0;
+
+    QBENCHMARK {
+        for (int i = 0 ; i < 1000;i++) {
+            DQQuery<HealthCheck> filtered = query.filter(DQWhere("name") == "record 1" && DQWhere("height") == i % 200);
+            if (filtered.exec()) {
+                while (filtered.next())
+                    total++;
+                filtered.finish();
+            }
+        }
+    }
+
+    QVERIFY(total > 0);
+
+    sql.setSqlCacheCapacity(origCapacity);
+}
+
+void BenchmarkTests::preparedQuery_data(){
+    QTest::addColumn<bool>("prepared");
+
+    QTest::newRow("DQQuery") << false;
+    QTest::newRow("DQPreparedQuery") << true;
+}
+
+void BenchmarkTests::preparedQuery(){
+    QFETCH(bool,prepared);
+
+    DQQuery<HealthCheck> query;
+    DQPreparedQuery<HealthCheck> preparedQuery(query.filter(DQWhere("id") == DQParam("id")));
+    QVERIFY(preparedQuery.isValid());
+    int total = 0;
+
+    QBENCHMARK {
+        for (int i = 1 ; i <= InitialRecordCount;i++) {
+            if (prepared) {
+                total += preparedQuery.bind("id",i).all().size();
+            } else {
+                DQQuery<HealthCheck> filtered = query.filter(DQWhere("id") == i);
+                total += filtered.all().size();
+            }
+        }
+    }
+
+    QVERIFY(total > 0);
+}
+
+void BenchmarkTests::filterBinding_data(){
+    QTest::addColumn<bool>("execute");
+
+    QTest::newRow("expression") << false;
+    QTest::newRow("exec") << true;
+}
+
+void BenchmarkTests::filterBinding(){
+    QFETCH(bool,execute);
+
+    DQWhere where = DQWhere("height") >= 0;
+    for (int i = 1 ; i < 20;i++) {
+        where = where && DQWhere("weight") != -i;
+    }
+
+    DQQuery<HealthCheck> query;
+    int total = 0;
+
+    QBENCHMARK {
+        for (int i = 0 ; i < 1000;i++) {
+            if (execute) {
+                DQQuery<HealthCheck> filtered = query.filter(where).limit(1);
+                if (filtered.exec()) {
+                    while (filtered.next())
+                        total++;
+                    filtered.finish();
+                }
+            } else {
+                DQExpression expression(where);
+                total += expression.bindValues().size();
+            }
+        }
+    }
+
+    QVERIFY(total > 0);
+}
+
+void BenchmarkTests::largeIn_data(){
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("200") << 200;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("50000") << 50000;
+}
+
+void BenchmarkTests::largeIn(){
+    QFETCH(int,size);
+
+    QList<QVariant> ids;
+    for (int i = 1 ; i <= size;i++) {
+        ids << i;
+    }
+
+    DQQuery<HealthCheck> query;
+    int total = 0;
+
+    QBENCHMARK {
+        total += query.filter(DQWhere("id").in(ids)).count();
+    }
+
+    QVERIFY(total > 0);
+}
+
+void BenchmarkTests::groupBy_data(){
+    QTest::addColumn<bool>("grouped");
+
+    QTest::newRow("per group") << false;
+    QTest::newRow("groupBy") << true;
+}
+
+void BenchmarkTests::groupBy(){
+    QFETCH(bool,grouped);
+
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().groupBy("height");
+    QVector<int> heights = query.values<int>("height");
+    QVERIFY(heights.size() > 0);
+
+    QList<DQAggregate> aggregates;
+    aggregates << DQAggregate("count","id") << DQAggregate("avg","weight") << DQAggregate("max","weight");
+
+    int total = 0;
+
+    QBENCHMARK {
+        if (grouped) {
+            DQColumnSet stats = query.aggregate(aggregates);
+            total += stats.rowCount();
+        } else {
+            foreach (int height , heights) {
+                DQQuery<HealthCheck> group = DQQuery<HealthCheck>().filter(DQWhere("height") == height);
+                group.count();
+                group.call("avg","weight");
+                group.call("max","weight");
+                total++;
+            }
+        }
+    }
+
+    QVERIFY(total > 0);
+}
+
+void BenchmarkTests::exists_data(){
+    QTest::addColumn<QString>("method");
+
+    QTest::newRow("count") << "count";
+    QTest::newRow("get") << "get";
+    QTest::newRow("exists") << "exists";
+}
+
+void BenchmarkTests::exists(){
+    QFETCH(QString,method);
+
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().filter(DQWhere("height") > 0);
+    int total = 0;
+
+    QBENCHMARK {
+        for (int i = 0 ; i < 100;i++) {
+            if (method == "count") {
+                if (query.count() > 0)
+                    total++;
+            } else if (method == "get") {
+                HealthCheck record;
+                if (record.load(DQWhere("height") > 0))
+                    total++;
+            } else {
+                if (query.exists())
+                    total++;
+            }
+        }
+    }
+
+    QVERIFY(total > 0);
+}
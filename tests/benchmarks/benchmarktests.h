@@ -0,0 +1,143 @@
+#ifndef BENCHMARKTESTS_H
+#define BENCHMARKTESTS_H
+
+#include <QtCore/QString>
+#include <QtTest/QtTest>
+#include <QtCore/QCoreApplication>
+
+#include <QSqlError>
+#include <dqconnection.h>
+#include <dqconnectionpool.h>
+#include <dqquery.h>
+#include <dqsql.h>
+#include <dqasync.h>
+#include <dqpreparedquery.h>
+#include <dqexpression.h>
+
+#include "misc.h"
+
+/// Measure the max. interval between the timer events of the event loop
+class LatencyProbe : public QObject
+{
+    Q_OBJECT
+
+public:
+    LatencyProbe(QObject* parent = 0);
+
+    /// The max. interval in ms since start()
+    qint64 maxInterval() const;
+
+    void start();
+
+public Q_SLOTS:
+    void tick();
+
+private:
+    QElapsedTimer m_timer;
+    qint64 m_maxInterval;
+};
+
+/// Performance benchmarks
+/**
+  The benchmarks use a file database (benchmark.db) in WAL mode ,
+  such that readers and writers in different threads could run concurrently.
+
+  Run with -iterations / -median options of QTestLib for stable result.
+ */
+
+class BenchmarkTests : public QObject
+{
+    Q_OBJECT
+
+public:
+    BenchmarkTests(QObject* parent = 0);
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    /// Throughput of read / write through DQConnectionPool with different no. of threads
+    void connectionPool_data();
+    void connectionPool();
+
+    /// DQModel::save() and load() with / without the statement cache
+    void statementCache_data();
+    void statementCache();
+
+    /// DQSharedList::save() with different chunk size
+    void bulkSave_data();
+    void bulkSave();
+
+    /// DQModel::save() of existing records by UPDATE of modified fields and REPLACE
+    void updateModified_data();
+    void updateModified();
+
+    /// Access the foreign key of all records with lazy load , prefetch() or selectRelated()
+    void prefetch_data();
+    void prefetch();
+
+    /// Peak memory usage of all() / iterate() on 1M records
+    void cursor_data();
+    void cursor();
+
+    /// Read records by column name (QSqlRecord) / precomputed column index (DQSharedQuery::recordTo())
+    void hydrate_data();
+    void hydrate();
+
+    /// Allocation count and time of all() with / without useArena() on 10k / 100k / 1M records
+    void arena_data();
+    void arena();
+
+    /// Read the fields of HealthCheck / AllType as QVariant (get()) / native type (value())
+    void fieldAccess_data();
+    void fieldAccess();
+
+    /// Create the meta info of 200 models
+    void metaInfoRegistration();
+
+    /// Max. event loop latency during all() / allAsync() on 1M records
+    void latency_data();
+    void latency();
+
+    /// Fetch a page by OFFSET / DQQuery::paginate() at different depth of 1M records , sorted by "id" or "height"
+    void pagination_data();
+    void pagination();
+
+    /// Read 2 fields of 100k records by select().all() / values()
+    void projection_data();
+    void projection();
+
+    /// Mean and histogram of 2 fields of 100k records by all() / columns()
+    void columnScan_data();
+    void columnScan();
+
+    /// Run the same filter shape with different values with / without the SQL cache
+    void sqlCache_data();
+    void sqlCache();
+
+    /// Load a record by id with DQQuery / DQPreparedQuery
+    void preparedQuery_data();
+    void preparedQuery();
+
+    /// Build and execute a filter of 20 predicates
+    void filterBinding_data();
+    void filterBinding();
+
+    /// Count the records matched with in() of a long list
+    void largeIn_data();
+    void largeIn();
+
+    /// Aggregate per group by a query per group / groupBy()
+    void groupBy_data();
+    void groupBy();
+
+    /// Check the existence of matched record by count() / get() / exists()
+    void exists_data();
+    void exists();
+
+private:
+    DQConnection connect;
+    QSqlDatabase db;
+};
+
+#endif // BENCHMARKTESTS_H
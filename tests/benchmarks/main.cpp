@@ -0,0 +1,12 @@
+#include <QCoreApplication>
+#include <QtTest/QtTest>
+#include "benchmarktests.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    BenchmarkTests tests;
+
+    return QTest::qExec(&tests,argc,argv);
+}
@@ -3,5 +3,6 @@
 ######################################################################
 
 TEMPLATE = subdirs
-SUBDIRS = unittests
+SUBDIRS = unittests \
+          benchmarks
 
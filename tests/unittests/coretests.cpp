@@ -147,6 +147,12 @@ void CoreTests::where(){
     filter = price.notEqual(qty);
     QVERIFY(filter.toString() == "price <> qty");
 
+    filter = price + 1;
+    QVERIFY(filter.toString() == "price + 1");
+
+    filter = price - 1;
+    QVERIFY(filter.toString() == "price - 1");
+
 }
 
 void CoreTests::expression(){
@@ -154,7 +160,39 @@ void CoreTests::expression(){
     DQExpression expression(where);
 
     qDebug() << expression.string();
-    QVERIFY(expression.string() == "(key = :arg0) and (length > :arg1)");
+    QVERIFY(expression.string() == "(key = ?) and (length > ?)");
+    QVERIFY(expression.bindValues().size() == 2);
+    QVERIFY(expression.bindValues().at(0) == "test");
+    QVERIFY(expression.bindValues().at(1) == 5);
+
+    DQExpression operand(QVariant(DQWhere("counter") + 1));
+    QVERIFY(operand.string() == "(counter + ?)");
+    QVERIFY(operand.bindValues().size() == 1);
+    QVERIFY(operand.bindValues().at(0) == 1);
+
+    // The values are bound in the order of placeholder
+    QList<QVariant> list;
+    list << 1 << 2;
+    DQExpression ordered(DQWhere("a").between(3,4) && DQWhere("b").in(list) && DQWhere("c") == 5);
+    QVERIFY(ordered.string() == "((a between ? and ?) and (b in (?,?))) and (c = ?)");
+    QVERIFY(ordered.bindValues() == (QVector<QVariant>() << 3 << 4 << 1 << 2 << 5));
+
+    // Every placeholder of a parameter is recorded
+    DQExpression params(DQWhere("uid") == DQParam("uid") || DQWhere("owner") == DQParam("uid"));
+    QVERIFY(params.string() == "(uid = ?) or (owner = ?)");
+    QVERIFY(params.params().size() == 1);
+    QVERIFY(params.params().value("uid") == (QList<int>() << 0 << 1));
+    QVERIFY(params.bindValues().size() == 2);
+
+    // The key is the structure of expression without values
+    QList<QVariant> list2;
+    list2 << 7 << 8;
+    QVERIFY(ordered.key() == DQExpression(DQWhere("a").between(5,6) && DQWhere("b").in(list2) && DQWhere("c") == 9).key());
+    QVERIFY(ordered.key() != DQExpression(DQWhere("a").between(3,4) && DQWhere("b").in(list2 << 9) && DQWhere("c") == 5).key());
+    QVERIFY(ordered.key() != DQExpression(DQWhere("a").between(3,4) && DQWhere("b").in(list) && DQWhere("c") > 5).key());
+    QVERIFY(ordered.key() != DQExpression(DQWhere("a").between(3,4) && DQWhere("b").in(list) && DQWhere("d") == 5).key());
+    QVERIFY(expression.key() != DQExpression(DQWhere("key = ","test") || DQWhere("length > ", 5)).key());
+    QVERIFY(DQExpression().key().isEmpty());
 
 }
 
@@ -191,6 +229,16 @@ void CoreTests::model1_accessFields(){
 
     QVERIFY(info->value(model,"key") == v);
 
+    // Access by index
+    int index = info->indexOf("key");
+    QVERIFY(index >= 0);
+    QVERIFY(info->at(index)->name == "key");
+    QVERIFY(info->value(model,index) == v);
+    QVERIFY(info->indexOf("not exists") == -1);
+
+    QVERIFY(!info->setValue(model,info->size(),v));
+    QVERIFY(info->value(model,info->size()).isNull());
+
     delete model;
 }
 
@@ -360,6 +408,50 @@ void CoreTests::stringlistField_data() {
 
 }
 
+void CoreTests::typedField(){
+    DQField<int> field;
+    QVERIFY(field.isNull());
+    QVERIFY(field.get().isNull());
+    QVERIFY(field.value() == 0);
+    QVERIFY(!field.isModified());
+
+    field.setValue(10);
+    QVERIFY(!field.isNull());
+    QVERIFY(field.isModified());
+    QVERIFY(field.value() == 10);
+    QVERIFY(field.get() == QVariant(10));
+    QVERIFY(field == 10);
+
+    // Converted to the native type on assignment
+    field = QVariant(QString("20"));
+    QVERIFY(field.value() == 20);
+    QVERIFY(field.get().type() == QVariant::Int);
+
+    // A read through operator-> do not mark the field modified
+    field.setModified(false);
+    QVERIFY(field->toInt() == 20);
+    QVERIFY(!field.isModified());
+    QVERIFY(field.value() == 20);
+
+    // Modification through operator-> is written back
+    field->setValue(30);
+    QVERIFY(field.isModified());
+    QVERIFY(field.value() == 30);
+
+    field.clear();
+    QVERIFY(field.isNull());
+    QVERIFY(field != 0);
+
+    // Access through the binder of meta info
+    HealthCheck record;
+    DQModelMetaInfo *info = record.metaInfo();
+    QVERIFY(info->setValue(&record,"height",QVariant(170)));
+    QVERIFY(record.height.value() == 170);
+    QVERIFY(info->value(&record,"height") == QVariant(170));
+    QVERIFY(info->setValue(&record,"height",QVariant()));
+    QVERIFY(record.height.isNull());
+}
+
 void CoreTests::stream() {
     HealthCheck record;
     DQStream stream(&record);
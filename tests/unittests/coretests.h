@@ -72,6 +72,9 @@ private Q_SLOTS:
     void stringlistField();
     void stringlistField_data();
 
+    /// Test the native typed storage of DQField
+    void typedField();
+
     /// test DQStream
     void stream();
 
@@ -1,4 +1,7 @@
 #include "sqlitetests.h"
+#include <QSet>
+#include <QThreadPool>
+#include <QRunnable>
 
 SqliteTests::SqliteTests(QObject* parent) : QObject(parent)
 {
@@ -130,10 +133,10 @@ void SqliteTests::insertInto(){
     DQModelMetaInfo *info = dqMetaInfo<Model2>();
     QString sql = statement.insertInto(info,info->fieldNameList());
 
-    QVERIFY( sql == "INSERT INTO model2 (id,key,value) values (:id,:key,:value);" );
+    QVERIFY( sql == "INSERT INTO model2 (id,key,value) values (?,?,?);" );
 
     sql = statement.replaceInto(info,info->fieldNameList());
-    QVERIFY( sql == "REPLACE INTO model2 (id,key,value) values (:id,:key,:value);" );
+    QVERIFY( sql == "REPLACE INTO model2 (id,key,value) values (?,?,?);" );
 
     DQConnection connection = DQConnection::defaultConnection();
     QVERIFY (connection.isOpen() );
@@ -549,3 +552,1176 @@ void SqliteTests::queryOrderBy(){
 
 }
 
+
+/// A thread that query the database via the default connection
+class ConnectionPoolTestThread : public QThread {
+public:
+    ConnectionPoolTestThread(DQConnection main) : mainConnection(main) {
+        opened = false;
+        isMainConnection = true;
+        count = -1;
+    }
+
+    void run() {
+        DQConnection connection = DQConnection::defaultConnection();
+        opened = connection.isOpen();
+        isMainConnection = connection == mainConnection;
+
+        DQQuery<HealthCheck> query;
+        count = query.count();
+    }
+
+    DQConnection mainConnection;
+    bool opened;
+    bool isMainConnection;
+    int count;
+};
+
+/// Count the records via the connection of the default pool in a thread of QThreadPool
+class ConnectionPoolTestTask : public QRunnable {
+public:
+    ConnectionPoolTestTask(int *count) : count(count) {
+    }
+
+    void run() {
+        DQQuery<HealthCheck> query;
+        *count = query.count();
+    }
+
+    int *count;
+};
+
+/// The names of databases cloned by DQConnectionPool
+static QStringList poolDatabaseNames() {
+    QStringList res;
+    foreach (QString name , QSqlDatabase::connectionNames()) {
+        if (name.startsWith("dquest-pool-"))
+            res << name;
+    }
+    return res;
+}
+
+void SqliteTests::connectionPool(){
+    DQQuery<HealthCheck> query;
+    int count = query.count();
+    QVERIFY(count > 0);
+
+    QVERIFY(DQConnectionPool::defaultPool() == 0);
+
+    DQConnectionPool pool;
+    QVERIFY(!pool.isOpen());
+    QVERIFY(pool.open(connect));
+    QVERIFY(pool.isOpen());
+    QVERIFY(DQConnectionPool::defaultPool() == &pool);
+
+    // The thread which opened the pool should use the original connection
+    QVERIFY(DQConnection::defaultConnection() == connect);
+
+    ConnectionPoolTestThread thread1(connect);
+    ConnectionPoolTestThread thread2(connect);
+
+    thread1.start();
+    thread2.start();
+
+    QVERIFY(thread1.wait());
+    QVERIFY(thread2.wait());
+
+    QVERIFY(thread1.opened);
+    QVERIFY(!thread1.isMainConnection);
+    QCOMPARE(thread1.count , count);
+
+    QVERIFY(thread2.opened);
+    QVERIFY(!thread2.isMainConnection);
+    QCOMPARE(thread2.count , count);
+
+    // The clones of exited threads are removed
+    QVERIFY(poolDatabaseNames().isEmpty());
+
+    // A long-lived thread of QThreadPool
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.setExpiryTimeout(-1);
+
+    int result = -1;
+    threadPool.start(new ConnectionPoolTestTask(&result));
+    threadPool.waitForDone();
+    QCOMPARE(result , count);
+
+    QStringList names = poolDatabaseNames();
+    QCOMPARE(names.size() , 1);
+
+    pool.close();
+    QVERIFY(!pool.isOpen());
+    QVERIFY(DQConnectionPool::defaultPool() == 0);
+    QVERIFY(DQConnection::defaultConnection() == connect);
+
+    // The clone of closed pool is released by the thread on next use
+    QVERIFY(pool.open(connect));
+    result = -1;
+    threadPool.start(new ConnectionPoolTestTask(&result));
+    threadPool.waitForDone();
+    QCOMPARE(result , count);
+
+    QCOMPARE(poolDatabaseNames().size() , 1);
+    QVERIFY(!poolDatabaseNames().contains(names.first()));
+
+    pool.close();
+    QVERIFY(DQConnectionPool::defaultPool() == 0);
+}
+
+void SqliteTests::statementCache(){
+    QVERIFY(connect.statementCacheCapacity() > 0);
+
+    Model1 model1,model2,model3;
+    model1.key = "statement cache 1";
+    model1.value = "1";
+    QVERIFY(model1.save());
+
+    int hits = connect.statementCacheHits();
+    int misses = connect.statementCacheMisses();
+
+    // Same fields , same SQL
+    model2.key = "statement cache 2";
+    model2.value = "2";
+    QVERIFY(model2.save());
+
+    QCOMPARE(connect.statementCacheHits() , hits + 1);
+    QCOMPARE(connect.statementCacheMisses() , misses);
+
+    QVERIFY(model3.load(DQWhere("id = " , model1.id)));
+    hits = connect.statementCacheHits();
+    QVERIFY(model3.load(DQWhere("id = " , model2.id)));
+    QCOMPARE(connect.statementCacheHits() , hits + 1);
+    QVERIFY(model3.key == "statement cache 2");
+
+    // An active query could not be reused
+    DQQuery<Model1> query1 = DQQuery<Model1>().filter(DQWhere("key = " , "statement cache 1"));
+    DQQuery<Model1> query2 = DQQuery<Model1>().filter(DQWhere("key = " , "statement cache 2"));
+
+    QVERIFY(query1.exec());
+    QVERIFY(query1.next());
+
+    misses = connect.statementCacheMisses();
+    QVERIFY(query2.exec());
+    QVERIFY(query2.next());
+    QCOMPARE(connect.statementCacheMisses() , misses + 1);
+
+    QVERIFY(query1.record().key == "statement cache 1");
+    QVERIFY(query2.record().key == "statement cache 2");
+
+    query1.finish();
+    query2.finish();
+
+    // Disable the cache
+    int capacity = connect.statementCacheCapacity();
+    connect.setStatementCacheCapacity(0);
+    hits = connect.statementCacheHits();
+    QVERIFY(model3.load(DQWhere("id = " , model1.id)));
+    QVERIFY(model3.load(DQWhere("id = " , model2.id)));
+    QCOMPARE(connect.statementCacheHits() , hits);
+    connect.setStatementCacheCapacity(capacity);
+
+    // The statement of lazy loaded foreign key is released and reused
+    DQList<ExamResult> results = DQQuery<ExamResult>().all();
+    QVERIFY(results.size() >= 2);
+    QVERIFY(!results.at(0)->uid->userId().isNull());
+    hits = connect.statementCacheHits();
+    QVERIFY(!results.at(1)->uid->userId().isNull());
+    QCOMPARE(connect.statementCacheHits() , hits + 1);
+
+    QVERIFY(model1.remove());
+    QVERIFY(model2.remove());
+}
+
+void SqliteTests::bulkSave(){
+    DQQuery<HealthCheck> query;
+    query = query.filter(DQWhere("name = " , "bulk"));
+    QVERIFY(query.remove());
+
+    DQList<HealthCheck> records;
+    QCOMPARE(records.saveChunkSize() , 1000);
+    records.setSaveChunkSize(300);
+
+    for (int i = 0 ; i < 1000;i++) {
+        HealthCheck* record = new HealthCheck();
+        record->name = "bulk";
+        record->height = i;
+        records.append(record);
+    }
+
+    QVERIFY(records.save());
+
+    QSet<int> ids;
+    for (int i = 0 ; i < records.size();i++) {
+        QVERIFY(!records.at(i)->id->isNull());
+        ids << records.at(i)->id().toInt();
+    }
+    QCOMPARE(ids.size() , 1000);
+
+    QCOMPARE(query.count() , 1000);
+
+    // Save within an existing transaction
+    QVERIFY(connect.sql().transaction());
+    records.setSaveChunkSize(0);
+    QVERIFY(records.save(true));
+    QVERIFY(connect.sql().rollback());
+
+    QCOMPARE(query.count() , 1000);
+
+    QVERIFY(query.remove());
+    QCOMPARE(query.count() , 0);
+
+    // The chunk with a failed item is rolled back
+    DQQuery<User> users = DQQuery<User>().filter(DQWhere("userId").in(QList<QVariant>() << "bulk0" << "bulk1" << "bulk2" << "bulk3"));
+    QVERIFY(users.remove());
+
+    DQList<User> list;
+    list.setSaveChunkSize(2);
+    for (int i = 0 ; i < 4;i++) {
+        User* user = new User();
+        user->userId = QString("bulk%1").arg(i);
+        user->passwd = i == 3 ? "short" : "12345678"; // clean() fails with short password
+        list.append(user);
+    }
+
+    QVERIFY(!list.save());
+    QCOMPARE(users.count() , 2);
+    QCOMPARE(users.filter(DQWhere("userId") == "bulk2").count() , 0);
+    QCOMPARE(connect.sql().transactionDepth() , 0);
+
+    QVERIFY(users.remove());
+}
+
+void SqliteTests::transaction(){
+    DQQuery<Model1> query = DQQuery<Model1>().filter(DQWhere("key = " , "transaction"));
+    QVERIFY(query.remove());
+
+    QVERIFY(!DQTransaction().isActive());
+
+    {
+        DQTransaction transaction = connect.transaction();
+        QVERIFY(transaction.isActive());
+
+        Model1 model;
+        model.key = "transaction";
+        QVERIFY(model.save());
+        QCOMPARE(query.count() , 1);
+    } // Rollback on destruction
+
+    QCOMPARE(query.count() , 0);
+    QCOMPARE(connect.sql().transactionDepth() , 0);
+
+    DQTransaction outer = connect.transaction();
+    Model1 model1;
+    model1.key = "transaction";
+    QVERIFY(model1.save());
+
+    {
+        DQTransaction inner = connect.transaction();
+        QVERIFY(inner.isActive());
+        QCOMPARE(connect.sql().transactionDepth() , 2);
+
+        Model1 model2;
+        model2.key = "transaction";
+        QVERIFY(model2.save());
+        QCOMPARE(query.count() , 2);
+
+        QVERIFY(inner.rollback());
+        QVERIFY(!inner.isActive());
+    }
+
+    QCOMPARE(query.count() , 1);
+
+    {
+        DQTransaction inner = connect.transaction();
+        Model1 model3;
+        model3.key = "transaction";
+        QVERIFY(model3.save());
+        QVERIFY(inner.commit());
+    }
+
+    QCOMPARE(query.count() , 2);
+
+    // Finishing the outer transaction will also finish the nested transaction
+    DQTransaction inner = connect.transaction();
+    QVERIFY(outer.commit());
+    QVERIFY(!outer.isActive());
+    QVERIFY(!inner.isActive());
+    QVERIFY(!inner.commit());
+    QCOMPARE(connect.sql().transactionDepth() , 0);
+
+    QCOMPARE(query.count() , 2);
+    QVERIFY(query.remove());
+}
+
+void SqliteTests::modifiedFields(){
+    HealthCheck record;
+    QVERIFY(!record.name.isModified());
+
+    record.name = "modified";
+    record.height = 100;
+    record.weight = 50;
+    QVERIFY(record.name.isModified());
+    QVERIFY(!record.recordDate.isModified());
+
+    QVERIFY(record.save());
+    QVERIFY(!record.name.isModified());
+    QVERIFY(!record.id.isModified());
+
+    HealthCheck loaded;
+    QVERIFY(loaded.load(DQWhere("id = " , record.id)));
+    QVERIFY(!loaded.name.isModified());
+    QVERIFY(!loaded.height.isModified());
+
+    // Read through the proxy do not mark the field modified
+    QVERIFY(!loaded.id->isNull());
+    QVERIFY(loaded.height->toInt() == 100);
+    QVERIFY(!loaded.id.isModified());
+    QVERIFY(!loaded.height.isModified());
+
+    loaded.height = 120;
+    QVERIFY(loaded.height.isModified());
+    QVERIFY(!loaded.name.isModified());
+
+    QVERIFY(loaded.save());
+    QVERIFY(connect.lastQuery().lastQuery().startsWith("UPDATE"));
+    QVERIFY(!loaded.height.isModified());
+
+    HealthCheck check;
+    QVERIFY(check.load(DQWhere("id = " , record.id)));
+    QVERIFY(check.name == "modified");
+    QVERIFY(check.height == 120);
+    QVERIFY(check.weight == 50);
+
+    // Nothing changed. No statement should be executed
+    int hits = connect.statementCacheHits();
+    int misses = connect.statementCacheMisses();
+    QVERIFY(loaded.save());
+    int hitsAfterSave = connect.statementCacheHits();
+    int missesAfterSave = connect.statementCacheMisses();
+    QCOMPARE(hitsAfterSave , hits);
+    QCOMPARE(missesAfterSave , misses);
+
+    // The record is removed from database. It should be inserted again.
+    QVERIFY(check.remove());
+    loaded.weight = 60;
+    QVERIFY(loaded.save());
+
+    QVERIFY(check.load(DQWhere("id = " , record.id)));
+    QVERIFY(check.height == 120);
+    QVERIFY(check.weight == 60);
+
+    QVERIFY(check.remove());
+}
+
+void SqliteTests::bulkUpdate(){
+    DQQuery<HealthCheck> query;
+    query = query.filter(DQWhere("name = " , "update"));
+    QVERIFY(query.remove());
+
+    DQList<HealthCheck> records;
+    DQListWriter writer(&records);
+
+    writer << "update" << 100 << 50 << writer.next()
+           << "update" << 110 << 60 << writer.next()
+           << "update" << 120 << 70 << writer.next();
+
+    writer.close();
+    QVERIFY(records.save());
+
+    QVariantMap assignments;
+    assignments["weight"] = 80;
+    assignments["height"] = DQWhere("height") + 1;
+
+    DQQuery<HealthCheck> tall = query.filter(DQWhere("name = " , "update") && DQWhere("height >= " , 110));
+    QCOMPARE(tall.update(assignments) , 2);
+
+    DQWhere name = DQWhere("name") == "update";
+    QCOMPARE(query.filter(name && (DQWhere("weight") == 80)).count() , 2);
+    QCOMPARE(query.filter(name && (DQWhere("height") == 111)).count() , 1);
+    QCOMPARE(query.filter(name && (DQWhere("height") == 121)).count() , 1);
+    QCOMPARE(query.filter(name && (DQWhere("height") == 100)).count() , 1);
+
+    // No record matched
+    QCOMPARE(query.filter(name && (DQWhere("height") > 1000)).update(assignments) , 0);
+
+    // Unknown field
+    QVariantMap invalid;
+    invalid["unknown"] = 1;
+    QCOMPARE(query.update(invalid) , -1);
+
+    QVERIFY(query.remove());
+}
+
+void SqliteTests::prefetch(){
+    DQList<ExamResult> results = DQQuery<ExamResult>().prefetch("uid").all();
+    QVERIFY(results.size() >= 2);
+
+    for (int i = 0 ; i < results.size();i++) {
+        QVERIFY(results.at(i)->uid.isLoaded());
+    }
+
+    QVERIFY(results.at(0)->uid->userId == "benlau");
+
+    // The linked model is shared between records
+    QVERIFY(results.at(0)->uid == results.at(1)->uid);
+    QVERIFY(&results.at(0)->uid() == &results.at(1)->uid());
+
+    results = DQQuery<ExamResult>().all();
+    QVERIFY(!results.at(0)->uid.isLoaded());
+    QVERIFY(results.at(0)->uid->userId == "benlau"); // Load on access
+    QVERIFY(results.at(0)->uid.isLoaded());
+}
+
+void SqliteTests::selectRelated(){
+    DQSqliteStatement statement;
+    DQQuery<ExamResult> query = DQQuery<ExamResult>().selectRelated("uid").orderBy("mark desc");
+
+    QString sql = statement.select(query);
+    QVERIFY(sql.contains("LEFT JOIN user AS t1 ON t0.uid = t1.id"));
+    QVERIFY(sql.contains("t1.userId AS uid__userId"));
+    QVERIFY(sql.contains("ORDER BY t0.mark desc"));
+
+    // Only the bare column names are qualified
+    DQQuery<ExamResult> expression = query.orderBy(QStringList() << "abs(mark) DESC" << "subject ASC" << "id");
+    sql = statement.select(expression);
+    QVERIFY(sql.contains("ORDER BY abs(mark) DESC,t0.subject ASC,t0.id"));
+    QVERIFY(expression.all().size() == query.all().size());
+
+    DQList<ExamResult> results = query.all();
+    QVERIFY(results.size() >= 2);
+
+    for (int i = 0 ; i < results.size();i++) {
+        QVERIFY(results.at(i)->uid.isLoaded());
+    }
+
+    QVERIFY(results.at(0)->mark().toInt() >= results.at(1)->mark().toInt());
+    QVERIFY(results.at(0)->uid->userId == "benlau");
+
+    // "id" exists on both tables. The filter should apply on the main table.
+    int id = results.at(1)->id().toInt();
+    results = DQQuery<ExamResult>().filter(DQWhere("id") == id).selectRelated("uid").all();
+    QVERIFY(results.size() == 1);
+    QVERIFY(results.at(0)->id().toInt() == id);
+    QVERIFY(results.at(0)->uid.isLoaded());
+    QVERIFY(!results.at(0)->mark.isModified());
+
+    // Select subset of fields without the foreign key
+    results = DQQuery<ExamResult>().select("mark").selectRelated("uid").all();
+    QVERIFY(results.size() >= 2);
+    QVERIFY(results.at(0)->uid.isLoaded());
+}
+
+void SqliteTests::cursor(){
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().orderBy("name");
+    DQList<HealthCheck> list = query.all();
+    QVERIFY(list.size() > 0);
+
+    DQCursor<HealthCheck> cursor = query.iterate();
+    const HealthCheck *model = 0;
+    int count = 0;
+
+    for (DQCursor<HealthCheck>::iterator iter = cursor.begin() ; iter != cursor.end() ; ++iter) {
+        if (model)
+            QVERIFY(model == &(*iter)); // The model is reused
+        model = &(*iter);
+
+        QVERIFY(count < list.size());
+        QVERIFY(iter->id() == list.at(count)->id());
+        QVERIFY(iter->name() == list.at(count)->name());
+        count++;
+    }
+
+    QVERIFY(count == list.size());
+
+    // A cursor could only be iterated once
+    QVERIFY(cursor.begin() == cursor.end());
+
+    // Empty result
+    DQQuery<HealthCheck> emptyQuery = DQQuery<HealthCheck>().filter(DQWhere("name") == "not exists");
+    DQCursor<HealthCheck> empty = emptyQuery.iterate();
+    QVERIFY(empty.begin() == empty.end());
+
+    // The original query is not affected by the cursor
+    QVERIFY(query.count() == list.size());
+}
+
+void SqliteTests::arena(){
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().orderBy("name");
+    DQList<HealthCheck> list = query.all();
+    QVERIFY(!list.isArenaEnabled());
+    QVERIFY(list.size() > 1);
+
+    DQList<HealthCheck> arena = query.useArena().all();
+    QVERIFY(arena.isArenaEnabled());
+    QVERIFY(arena.size() == list.size());
+
+    for (int i = 0 ; i < list.size();i++) {
+        QVERIFY(arena.at(i)->id() == list.at(i)->id());
+        QVERIFY(arena.at(i)->name() == list.at(i)->name());
+    }
+
+    // Models from the arena and the heap could be mixed
+    int n = arena.size();
+    HealthCheck *model = new HealthCheck();
+    model->name = "heap";
+    QVERIFY(arena.append(model));
+    QVERIFY(arena.size() == n + 1);
+
+    arena.removeAt(0);
+    QVERIFY(arena.size() == n);
+    QVERIFY(arena.at(0)->id() == list.at(1)->id());
+
+    // It could not be disabled until it is cleared
+    arena.setArenaEnabled(false);
+    QVERIFY(arena.isArenaEnabled());
+
+    arena.clear();
+    QVERIFY(arena.size() == 0);
+    arena.setArenaEnabled(false);
+    QVERIFY(!arena.isArenaEnabled());
+}
+
+/// A task that blocks the worker thread until it is released
+class BlockingTask : public DQAsyncResultTask<bool> {
+public:
+    BlockingTask() {
+        started = 0;
+        released = 0;
+    }
+
+    QAtomicInt started;
+    QAtomicInt released;
+
+protected:
+    bool exec(DQConnection connection) {
+        Q_UNUSED(connection);
+        started.fetchAndStoreOrdered(1);
+        while (!released.fetchAndAddOrdered(0))
+            QThread::msleep(1);
+        return true;
+    }
+};
+
+void SqliteTests::async(){
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().orderBy("name");
+    DQList<HealthCheck> list = query.all();
+    QVERIFY(list.size() > 1);
+
+    QFuture<int> count = query.countAsync();
+    QFuture<DQSharedList> all = query.allAsync();
+    QFuture<QVariant> max = query.callAsync("max","height");
+
+    QVERIFY(count.result() == query.count());
+    QVERIFY(max.result() == query.call("max","height"));
+
+    DQList<HealthCheck> result = all.result();
+    QVERIFY(result.size() == list.size());
+    for (int i = 0 ; i < list.size();i++) {
+        QVERIFY(result.at(i)->id() == list.at(i)->id());
+        QVERIFY(result.at(i)->name() == list.at(i)->name());
+        // The models could be used by the calling thread
+        QVERIFY(result.at(i)->connection() == connect);
+    }
+
+    HealthCheck model;
+    model.name = "async";
+    model.height = 170;
+    QFuture<bool> saved = model.saveAsync();
+    QVERIFY(saved.result());
+    QVERIFY(!model.id->isNull());
+    QVERIFY(model.connection() == connect);
+
+    HealthCheck loaded;
+    QVERIFY(loaded.load(DQWhere("id") == model.id()));
+    QVERIFY(loaded.name() == "async");
+    QVERIFY(loaded.remove());
+
+    // Cancel a queued query
+    BlockingTask *blocker = new BlockingTask();
+    QFuture<bool> blocked = blocker->future();
+    connect.runAsync(blocker);
+    while (!blocker->started.fetchAndAddOrdered(0))
+        QThread::msleep(1);
+
+    QFuture<int> canceled = query.countAsync();
+    QFuture<int> queued = query.countAsync();
+    canceled.cancel();
+    blocker->released.fetchAndStoreOrdered(1);
+
+    QVERIFY(blocked.result());
+    QVERIFY(queued.result() == list.size());
+    canceled.waitForFinished();
+    QVERIFY(canceled.isCanceled());
+
+    // A clone of :memory: database would be empty. It is refused.
+    {
+        QSqlDatabase memoryDb = QSqlDatabase::addDatabase("QSQLITE","dquest-async-memory");
+        memoryDb.setDatabaseName(":memory:");
+        QVERIFY(memoryDb.open());
+
+        DQConnection memory;
+        QVERIFY(memory.open(memoryDb));
+        QVERIFY(memory.addModel<HealthCheck>());
+        QVERIFY(memory.createTables());
+
+        DQQuery<HealthCheck> memoryQuery(memory);
+        QVERIFY(memoryQuery.count() == 0);
+        QFuture<int> refused = memoryQuery.countAsync();
+        refused.waitForFinished();
+        QVERIFY(refused.isCanceled());
+
+        memory.close();
+        memoryDb.close();
+    }
+    QSqlDatabase::removeDatabase("dquest-async-memory");
+}
+
+void SqliteTests::stream(){
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().orderBy("name");
+    DQList<HealthCheck> list = query.all();
+    QVERIFY(list.size() > 2);
+
+    int count = 0;
+    DQQueryStream<HealthCheck> stream = query.stream(2);
+    for (DQQueryStream<HealthCheck>::iterator iter = stream.begin() ; iter != stream.end() ; ++iter) {
+        QVERIFY(iter->id() == list.at(count)->id());
+        QVERIFY(iter->name() == list.at(count)->name());
+        QVERIFY(iter->connection() == connect);
+        count++;
+    }
+    QVERIFY(count == list.size());
+
+    // The filter is applied
+    DQQuery<HealthCheck> filtered = query.filter(DQWhere("id") == list.at(0)->id());
+    DQQueryStream<HealthCheck> single = filtered.stream();
+    DQQueryStream<HealthCheck>::iterator iter = single.begin();
+    QVERIFY(iter != single.end());
+    QVERIFY(iter->id() == list.at(0)->id());
+    ++iter;
+    QVERIFY(iter == single.end());
+
+    // Read by pages
+    DQSharedQueryStream pages(query,2);
+    QVERIFY(pages.nextPage().size() == 2);
+    QFuture<DQSharedList> page = pages.fetchPage();
+    QVERIFY(page.result().size() == qMin(2,list.size() - 2));
+
+    // Early termination
+    pages.close();
+    QVERIFY(pages.nextPage().size() == 0);
+
+    {
+        DQQueryStream<HealthCheck> partial = query.stream(1);
+        QVERIFY(partial.begin() != partial.end());
+    }
+
+    // The worker is not blocked by the closed streams
+    QVERIFY(query.countAsync().result() == list.size());
+}
+
+void SqliteTests::paginate(){
+    DQList<HealthCheck> records;
+    DQListWriter writer(&records);
+
+    writer << "page" << 150 << 50 << writer.next()
+           << "page" << 160 << 60 << writer.next()
+           << "page" << 160 << 70 << writer.next()
+           << "page" << 170 << 80 << writer.next()
+           << "page" << 170 << 90 << writer.next();
+    writer.close();
+    QVERIFY(records.save());
+
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().filter(DQWhere("name") == "page");
+    DQList<HealthCheck> list = query.orderBy(QStringList() << "height" << "id").all();
+    QVERIFY(list.size() == 5);
+
+    // Offset
+    DQList<HealthCheck> result = query.orderBy(QStringList() << "height" << "id").limit(2).offset(1).all();
+    QVERIFY(result.size() == 2);
+    QVERIFY(result.at(0)->id() == list.at(1)->id());
+    QVERIFY(result.at(1)->id() == list.at(2)->id());
+
+    // Offset without limit
+    result = query.orderBy(QStringList() << "height" << "id").offset(3).all();
+    QVERIFY(result.size() == 2);
+    QVERIFY(result.at(0)->id() == list.at(3)->id());
+
+    // Keyset pagination with duplicated key
+    DQPaginator<HealthCheck> paginator = query.paginate(2,"height");
+    QList<QVariant> ids;
+    while (paginator.hasNext()) {
+        DQList<HealthCheck> page = paginator.nextPage();
+        QVERIFY(page.size() <= 2);
+        for (int i = 0 ; i < page.size();i++) {
+            ids << page.at(i)->id();
+        }
+    }
+    QVERIFY(paginator.pageCount() == 3);
+    QVERIFY(ids.size() == list.size());
+    for (int i = 0 ; i < list.size();i++) {
+        QVERIFY(ids.at(i) == list.at(i)->id());
+    }
+    QVERIFY(paginator.nextPage().size() == 0);
+
+    // Resume from another paginator
+    paginator.reset();
+    paginator.nextPage();
+    DQPaginator<HealthCheck> resumed = query.paginate(2,"height");
+    resumed.seek(paginator.lastKey(),paginator.lastId());
+    result = resumed.nextPage();
+    QVERIFY(result.size() == 2);
+    QVERIFY(result.at(0)->id() == list.at(2)->id());
+
+    // Order by id
+    DQPaginator<HealthCheck> byId = query.paginate(4);
+    QVERIFY(byId.nextPage().size() == 4);
+    QVERIFY(byId.nextPage().size() == 1);
+    QVERIFY(!byId.hasNext());
+
+    QVERIFY(query.remove());
+}
+
+void SqliteTests::values(){
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().orderBy("id");
+    DQList<HealthCheck> list = query.all();
+    QVERIFY(list.size() > 1);
+
+    QVector<int> ids = query.values<int>("id");
+    QVERIFY(ids.size() == list.size());
+
+    QVector<DQTuple<int,QString> > pairs = query.values<int,QString>("height","name");
+    QVERIFY(pairs.size() == list.size());
+
+    QVector<DQTuple<int,QString,double,int> > rows = query.values<int,QString,double,int>("height","name","weight","id");
+    QVERIFY(rows.size() == list.size());
+
+    for (int i = 0 ; i < list.size();i++) {
+        HealthCheck *record = list.at(i);
+        QVERIFY(ids.at(i) == record->id.value());
+        QVERIFY(pairs.at(i).first == record->height.value());
+        QVERIFY(pairs.at(i).second == record->name.value());
+        QVERIFY(rows.at(i).third == record->weight.value());
+        QVERIFY(rows.at(i).fourth == ids.at(i));
+    }
+
+    // The filter is applied
+    DQQuery<HealthCheck> filtered = query.filter(DQWhere("id") == ids.at(0));
+    QVector<QString> names = filtered.values<QString>("name");
+    QVERIFY(names.size() == 1);
+    QVERIFY(names.at(0) == list.at(0)->name.value());
+}
+
+void SqliteTests::columns(){
+    DQList<HealthCheck> records;
+    for (int i = 0 ; i < 5;i++) {
+        HealthCheck *record = new HealthCheck();
+        record->name = "column";
+        if (i != 2) {
+            record->height = 150 + i * 10; // 150,160,-,180,190
+        }
+        record->weight = 50.5 + i;
+        records.append(record);
+    }
+    QVERIFY(records.save());
+
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().filter(DQWhere("name") == "column").orderBy("id");
+    DQColumnSet set = query.columns(QStringList() << "height" << "weight" << "name");
+
+    QVERIFY(set.rowCount() == 5);
+    QVERIFY(set.columnCount() == 3);
+    QVERIFY(set.indexOf("weight") == 1);
+    QVERIFY(set.indexOf("recordDate") == -1);
+
+    const DQColumn& height = set.column("height");
+    QVERIFY(height.isNumeric());
+    QVERIFY(height.ints().size() == 5);
+    QVERIFY(height.nullCount() == 1);
+    QVERIFY(height.isNull(2));
+    QVERIFY(!height.isNull(3));
+    QVERIFY(height.value(2).isNull());
+    QVERIFY(height.value(3) == 180);
+    QVERIFY(height.sum() == 680);
+    QVERIFY(height.min() == 150);
+    QVERIFY(height.max() == 190);
+    QVERIFY(height.mean() == 170);
+
+    QVector<int> histogram = height.histogram(4,150,190);
+    QVERIFY(histogram.size() == 4);
+    QVERIFY(histogram.at(0) == 1);
+    QVERIFY(histogram.at(1) == 1);
+    QVERIFY(histogram.at(2) == 0);
+    QVERIFY(histogram.at(3) == 2);
+
+    const DQColumn& weight = set.column("weight");
+    QVERIFY(weight.doubles().size() == 5);
+    QVERIFY(weight.nullCount() == 0);
+    QVERIFY(weight.min().toDouble() == 50.5);
+    QVERIFY(weight.max().toDouble() == 54.5);
+    QVERIFY(weight.sum() == 262.5);
+
+    const DQColumn& name = set.column("name");
+    QVERIFY(!name.isNumeric());
+    QVERIFY(name.variants().size() == 5);
+    QVERIFY(name.value(0) == "column");
+    QVERIFY(name.min().isNull());
+
+    // All fields
+    set = query.columns();
+    QVERIFY(set.columnCount() == dqMetaInfo<HealthCheck>()->size());
+    QVERIFY(set.rowCount() == 5);
+
+    // The sum of an int column is not overflowed
+    for (int i = 0 ; i < 2;i++) {
+        HealthCheck large;
+        large.name = "column";
+        large.height = 2000000000;
+        large.weight = 0;
+        QVERIFY(large.save());
+    }
+
+    set = query.columns(QStringList() << "height");
+    QVERIFY(set.column("height").sum() == 4000000680.0);
+
+    // The sum of an int field is retrieved as LongLong
+    set = query.groupBy("name").aggregate(QList<DQAggregate>() << DQAggregate("sum","height"));
+    QVERIFY(set.column("sum(height)").type() == QVariant::LongLong);
+    QVERIFY(set.column("sum(height)").longLongs().at(0) == Q_INT64_C(4000000680));
+
+    QVERIFY(query.remove());
+}
+
+void SqliteTests::sqlCache(){
+    DQSql sql = connect.sql();
+    QVERIFY(sql.sqlCacheCapacity() > 0);
+
+    DQQuery<HealthCheck> query;
+    DQList<HealthCheck> list = query.orderBy("id").all();
+    QVERIFY(list.size() > 1);
+
+    DQQuery<HealthCheck> query1 = query.filter(DQWhere("id") == list.at(0)->id());
+    DQQuery<HealthCheck> query2 = query.filter(DQWhere("id") == list.at(1)->id());
+
+    // Same shape , different values
+    QString sql1 = sql.selectStatement(query1);
+    int hits = sql.sqlCacheHits();
+    int misses = sql.sqlCacheMisses();
+    QString sql2 = sql.selectStatement(query2);
+    QCOMPARE(sql.sqlCacheHits() , hits + 1);
+    QCOMPARE(sql.sqlCacheMisses() , misses);
+    QVERIFY(sql1 == sql2);
+
+    DQList<HealthCheck> result1 = query1.all();
+    DQList<HealthCheck> result2 = query2.all();
+    QVERIFY(result1.at(0)->id() == list.at(0)->id());
+    QVERIFY(result2.at(0)->id() == list.at(1)->id());
+
+    // Different shape
+    hits = sql.sqlCacheHits();
+    misses = sql.sqlCacheMisses();
+    QString sql3 = sql.selectStatement(query1.limit(1));
+    QCOMPARE(sql.sqlCacheHits() , hits);
+    QCOMPARE(sql.sqlCacheMisses() , misses + 1);
+    QVERIFY(sql3 != sql1);
+
+    QVERIFY(sql.deleteStatement(query1) != sql1);
+
+    // Disabled
+    int capacity = sql.sqlCacheCapacity();
+    sql.setSqlCacheCapacity(0);
+    hits = sql.sqlCacheHits();
+    misses = sql.sqlCacheMisses();
+    QVERIFY(query1.count() == 1);
+    QVERIFY(query1.count() == 1);
+    QCOMPARE(sql.sqlCacheHits() , hits);
+    QCOMPARE(sql.sqlCacheMisses() , misses + 2);
+    sql.setSqlCacheCapacity(capacity);
+}
+
+void SqliteTests::preparedQuery(){
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().orderBy("id");
+    DQList<HealthCheck> list = query.all();
+    QVERIFY(list.size() > 1);
+
+    DQPreparedQuery<HealthCheck> prepared(query.filter(DQWhere("id") == DQParam("id") && DQWhere("name") != "-"));
+    QVERIFY(prepared.isValid());
+    QVERIFY(prepared.params() == QStringList() << "id");
+
+    for (int i = 0 ; i < list.size();i++) {
+        DQList<HealthCheck> result = prepared.bind("id",list.at(i)->id()).all();
+        QVERIFY(result.size() == 1);
+        QVERIFY(result.at(0)->id() == list.at(i)->id());
+        QVERIFY(result.at(0)->name() == list.at(i)->name());
+    }
+
+    // Unbound parameter is null
+    DQPreparedQuery<HealthCheck> unbound(query.filter(DQWhere("name") == DQParam("name")));
+    QVERIFY(unbound.all().size() == 0);
+
+    // Iterate the result
+    DQPreparedQuery<HealthCheck> range(query.filter(DQWhere("id") >= DQParam("from")));
+    QVERIFY(range.bind("from",list.at(1)->id()).exec());
+    int count = 0;
+    HealthCheck record;
+    while (range.next()) {
+        QVERIFY(range.recordTo(record));
+        count++;
+    }
+    range.finish();
+    QVERIFY(count == list.size() - 1);
+}
+
+void SqliteTests::largeIn(){
+    DQQuery<HealthCheck> query;
+    DQList<HealthCheck> list = query.all();
+    int total = list.size();
+    QVERIFY(total > 1);
+
+    QList<QVariant> ids;
+    for (int i = 0 ; i < list.size();i++) {
+        ids << list.at(i)->id();
+    }
+
+    // Pad the list with non-existed id
+    int n = DQExpression::valueTableThreshold() * 4;
+    for (int i = 1 ; i <= n;i++) {
+        ids << -i;
+    }
+
+    DQExpression expression(DQWhere("id").in(ids));
+    QVERIFY(expression.valueTables().size() == 1);
+    QString table = expression.valueTables().keys().at(0);
+    QVERIFY(table.startsWith("dq_in_"));
+    QVERIFY(expression.string() == QString("id in (SELECT v FROM %1)").arg(table));
+    QVERIFY(expression.bindValues().size() == 0);
+    QVERIFY(expression.valueTables().value(table).size() == ids.size());
+
+    // The temporary table is created in a transaction that is rolled back
+    {
+        DQTransaction transaction = connect.transaction();
+        QVERIFY(transaction.isActive());
+        QVERIFY(query.filter(DQWhere("id").in(ids)).count() == total);
+        QVERIFY(transaction.rollback());
+    }
+
+    QVERIFY(query.filter(DQWhere("id").in(ids)).count() == total);
+    QVERIFY(query.filter(DQWhere("id").notIn(ids)).count() == 0);
+
+    // Fixed size statement with different lists
+    QList<QVariant> half = ids.mid(total / 2);
+    query = query.filter(DQWhere("id").in(half));
+    QVERIFY(query.all().size() == total - total / 2);
+    QVERIFY(query.lastQuery().lastQuery().contains("(SELECT v FROM dq_in_"));
+
+    // Two live queries do not share a table
+    DQQuery<HealthCheck> live = query.filter(DQWhere("id").in(half));
+    QVERIFY(live.exec());
+    QVERIFY(query.filter(DQWhere("id").in(ids)).count() == total);
+    int count = 0;
+    while (live.next())
+        count++;
+    live.finish();
+    QVERIFY(count == total - total / 2);
+
+    // A prepared query fills the table once
+    DQPreparedQuery<HealthCheck> prepared(DQQuery<HealthCheck>().filter(DQWhere("id").in(ids) && DQWhere("name") != DQParam("name")));
+    QVERIFY(prepared.isValid());
+    DQSql sql = connect.sql();
+    int prepares = sql.statementCacheHits() + sql.statementCacheMisses();
+    QVERIFY(prepared.bind("name","-").all().size() == total);
+    QVERIFY(prepared.bind("name",list.at(0)->name()).all().size() < total);
+    QVERIFY(sql.statementCacheHits() + sql.statementCacheMisses() == prepares);
+
+    // A large list in the assignments of update() , together with a large list in the filter
+    QVariant weight = list.at(0)->weight();
+    QVariantMap assignments;
+    assignments["weight"] = DQWhere("id").notIn(ids.mid(1));
+    DQQuery<HealthCheck> single = DQQuery<HealthCheck>().filter(DQWhere("id").in(ids.mid(0,1) + ids.mid(total)));
+    QCOMPARE(single.update(assignments) , 1);
+
+    HealthCheck updated;
+    QVERIFY(updated.load(DQWhere("id") == list.at(0)->id()));
+    QVERIFY(updated.weight().toInt() == 1);
+    assignments["weight"] = weight;
+    QCOMPARE(single.update(assignments) , 1);
+
+    // Two large lists in the same filter
+    query.reset();
+    query = query.filter(DQWhere("id").in(ids) && DQWhere("id").notIn(half));
+    QVERIFY(query.count() == total / 2);
+
+    // Remove by a large list
+    DQSharedQuery removal = query.filter(DQWhere("id").in(ids.mid(total)));
+    QVERIFY(removal.remove());
+    QVERIFY(DQQuery<HealthCheck>().count() == total);
+}
+
+void SqliteTests::subquery(){
+    DQList<ExamResult> results = DQQuery<ExamResult>().all();
+    QVERIFY(results.size() > 0);
+
+    int mark = results.at(0)->mark().toInt();
+    QSet<int> uids;
+    QSet<int> passed;
+    for (int i = 0 ; i < results.size();i++) {
+        int uid = results.at(i)->uid.get().toInt();
+        uids << uid;
+        if (results.at(i)->mark().toInt() >= mark)
+            passed << uid;
+    }
+
+    DQQuery<User> query;
+    int userCount = query.count();
+    QVERIFY(userCount >= uids.size());
+
+    // The values of subquery are bound in the order of placeholder
+    DQExpression expression(DQWhere("id").in(DQQuery<ExamResult>().filter(DQWhere("mark") > 80).select("uid")) &&
+                            DQWhere("userId") != "x");
+    QVERIFY(expression.string() == "(id in (SELECT ALL uid FROM examresult WHERE mark > ?)) and (userId <> ?)");
+    QVERIFY(expression.bindValues() == (QVector<QVariant>() << 80 << "x"));
+
+    QVERIFY(query.filter(DQWhere("id").in(DQQuery<ExamResult>().select("uid"))).count() == uids.size());
+    QVERIFY(query.filter(DQWhere("id").notIn(DQQuery<ExamResult>().select("uid"))).count() == userCount - uids.size());
+
+    // "id" is selected by default
+    QVERIFY(DQQuery<ExamResult>().filter(DQWhere("uid").in(DQQuery<User>())).count() == results.size());
+
+    query = query.filter(DQWhere("id") > 0 &&
+                         DQWhere("id").in(DQQuery<ExamResult>().filter(DQWhere("mark") >= mark).select("uid")));
+    QVERIFY(query.count() == passed.size());
+
+    // Correlated subquery
+    query.reset();
+    DQSharedQuery correlated = DQQuery<ExamResult>().filter(DQWhere("uid") == DQWhere("user.id"));
+    QVERIFY(query.filter(DQWhere::exists(correlated)).count() == uids.size());
+    QVERIFY(query.filter(DQWhere::notExists(correlated)).count() == userCount - uids.size());
+
+    DQList<User> users = query.filter(DQWhere::exists(correlated)).all();
+    QVERIFY(users.size() == uids.size());
+    for (int i = 0 ; i < users.size();i++) {
+        QVERIFY(uids.contains(users.at(i)->id().toInt()));
+    }
+}
+
+void SqliteTests::groupBy(){
+    DQList<ExamResult> results = DQQuery<ExamResult>().all();
+    QVERIFY(results.size() > 0);
+
+    QMap<QString,int> counts;
+    QMap<QString,int> sums;
+    QMap<QString,int> maxs;
+    for (int i = 0 ; i < results.size();i++) {
+        QString subject = results.at(i)->subject().toString();
+        int mark = results.at(i)->mark().toInt();
+        counts[subject]++;
+        sums[subject] += mark;
+        maxs[subject] = counts[subject] == 1 ? mark : qMax(maxs[subject],mark);
+    }
+
+    DQSqliteStatement statement;
+    DQQuery<ExamResult> query = DQQuery<ExamResult>().groupBy("subject").having(DQWhere("count(id)") > 0);
+    QString sql = statement.select(query);
+    QVERIFY(sql.contains("GROUP BY subject HAVING count(id) > ?"));
+
+    QList<DQAggregate> aggregates;
+    aggregates << DQAggregate("count","id") << DQAggregate("avg","mark") << DQAggregate("max","mark");
+
+    DQColumnSet stats = DQQuery<ExamResult>().orderBy("subject").groupBy("subject").aggregate(aggregates);
+    QVERIFY(stats.names() == QStringList() << "subject" << "count(id)" << "avg(mark)" << "max(mark)");
+    QVERIFY(stats.rowCount() == counts.size());
+
+    for (int i = 0 ; i < stats.rowCount();i++) {
+        QString subject = stats.column("subject").value(i).toString();
+        QVERIFY(counts.contains(subject));
+        QVERIFY(stats.column("count(id)").ints().at(i) == counts[subject]);
+        QVERIFY(qAbs(stats.column("avg(mark)").doubles().at(i) - (double) sums[subject] / counts[subject]) < 0.0001);
+        QVERIFY(stats.column("max(mark)").value(i).toInt() == maxs[subject]);
+    }
+
+    // Filter the groups
+    int threshold = counts.values().first();
+    int matched = 0;
+    foreach (int count , counts) {
+        if (count > threshold)
+            matched++;
+    }
+
+    query = DQQuery<ExamResult>().filter(DQWhere("mark") >= 0).groupBy("subject").having(DQWhere("count(id)") > threshold);
+    QVERIFY(query.aggregate(QList<DQAggregate>() << DQAggregate("count","*")).rowCount() == matched);
+
+    // having() without groupBy() in subquery is ignored
+    DQExpression expression(DQWhere("id").in(DQQuery<ExamResult>().having(DQWhere("count(id)") > 1).select("uid")) &&
+                            DQWhere("userId") != "x");
+    QVERIFY(expression.string() == "(id in (SELECT ALL uid FROM examresult)) and (userId <> ?)");
+    QVERIFY(expression.bindValues() == (QVector<QVariant>() << "x"));
+
+    // Typed tuples
+    query = DQQuery<ExamResult>().groupBy("subject");
+    QVector<DQTuple<QString,int,int> > rows = query.values<QString,int,int>("subject","count(id)","sum(mark)");
+    QVERIFY(rows.size() == counts.size());
+    for (int i = 0 ; i < rows.size();i++) {
+        QVERIFY(rows.at(i).second == counts[rows.at(i).first]);
+        QVERIFY(rows.at(i).third == sums[rows.at(i).first]);
+    }
+}
+
+void SqliteTests::firstAndLast(){
+    DQQuery<HealthCheck> query = DQQuery<HealthCheck>().orderBy(QStringList() << "height desc" << "id");
+    DQList<HealthCheck> list = query.all();
+    QVERIFY(list.size() > 1);
+
+    QVERIFY(query.exists());
+    QVERIFY(connect.lastQuery().lastQuery().startsWith("SELECT ALL 1 FROM healthcheck"));
+    QVERIFY(connect.lastQuery().lastQuery().contains("LIMIT 1"));
+    QVERIFY(query.filter(DQWhere("name") == list.at(0)->name()).exists());
+    QVERIFY(!query.filter(DQWhere("name") == "-").exists());
+
+    QVERIFY(query.first("id") == list.at(0)->id());
+    QVERIFY(query.last("id") == list.at(list.size() - 1)->id());
+    QVERIFY(query.first("name") == list.at(0)->name());
+
+    HealthCheck record;
+    QVERIFY(query.first(record));
+    QVERIFY(record.id() == list.at(0)->id());
+    QVERIFY(query.last(record));
+    QVERIFY(record.id() == list.at(list.size() - 1)->id());
+
+    // Sort by id if orderBy() is not set
+    QVERIFY(DQQuery<HealthCheck>().first("id").toInt() <= DQQuery<HealthCheck>().last("id").toInt());
+
+    // The window of limit() and offset()
+    DQQuery<HealthCheck> window = query.offset(1).limit(list.size());
+    QVERIFY(window.first("id") == list.at(1)->id());
+    QVERIFY(window.last("id") == list.at(list.size() - 1)->id());
+    window = query.limit(1);
+    QVERIFY(window.last("id") == list.at(0)->id());
+    QVERIFY(window.last(record));
+    QVERIFY(record.id() == list.at(0)->id());
+    window = query.offset(list.size());
+    QVERIFY(window.last("id").isNull());
+    QVERIFY(connect.lastQuery().lastQuery().startsWith("SELECT * FROM (SELECT ALL id,height AS dq_order_0"));
+
+    // The window of groups
+    QStringList subjects;
+    DQList<ExamResult> results = DQQuery<ExamResult>().all();
+    for (int i = 0 ; i < results.size();i++) {
+        QString subject = results.at(i)->subject().toString();
+        if (!subjects.contains(subject))
+            subjects << subject;
+    }
+    subjects.sort();
+    QVERIFY(subjects.size() > 0);
+
+    DQQuery<ExamResult> groups = DQQuery<ExamResult>().groupBy("subject").orderBy("subject").limit(subjects.size() + 1);
+    QVERIFY(groups.last("subject") == subjects.last());
+    groups = DQQuery<ExamResult>().groupBy("subject").orderBy("subject desc").offset(subjects.size() - 1);
+    QVERIFY(groups.last("subject") == subjects.first());
+
+    // No record
+    QVERIFY(query.filter(DQWhere("name") == "-").first("id").isNull());
+    DQQuery<HealthCheck> empty = query.filter(DQWhere("name") == "-");
+    QVERIFY(!empty.last(record));
+
+    // The original query is not changed
+    QVERIFY(query.all().size() == list.size());
+}
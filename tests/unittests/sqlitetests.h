@@ -11,6 +11,9 @@
 #include <dqquery.h>
 #include <dqsql.h>
 #include <dqlistwriter.h>
+#include <dqconnectionpool.h>
+#include <dqasync.h>
+#include <dqpreparedquery.h>
 
 #include "model1.h"
 #include "model2.h"
@@ -76,6 +79,69 @@ private Q_SLOTS:
 
     void queryOrderBy();
 
+    /// Test DQConnectionPool with worker threads
+    void connectionPool();
+
+    /// Test the reuse of prepared queries
+    void statementCache();
+
+    /// Test DQSharedList::save() with a large list
+    void bulkSave();
+
+    /// Test DQTransaction and nested transaction
+    void transaction();
+
+    /// Test DQModel::save() with modified fields only
+    void modifiedFields();
+
+    /// Test DQSharedQuery::update()
+    void bulkUpdate();
+
+    /// Test DQQuery::prefetch()
+    void prefetch();
+
+    /// Test DQQuery::selectRelated()
+    void selectRelated();
+
+    /// Test DQQuery::iterate()
+    void cursor();
+
+    /// Test DQQuery::useArena()
+    void arena();
+
+    /// Test allAsync() , countAsync() , callAsync() and DQModel::saveAsync()
+    void async();
+
+    /// Test DQQuery::stream()
+    void stream();
+
+    /// Test DQQuery::offset() and DQQuery::paginate()
+    void paginate();
+
+    /// Test DQQuery::values()
+    void values();
+
+    /// Test DQSharedQuery::columns() and the kernels of DQColumn
+    void columns();
+
+    /// Test the SQL cache of DQSql::selectStatement()
+    void sqlCache();
+
+    /// Test DQPreparedQuery
+    void preparedQuery();
+
+    /// Test in() / notIn() with a list larger than the threshold of value table
+    void largeIn();
+
+    /// Test in() , notIn() , exists() and notExists() with subquery
+    void subquery();
+
+    /// Test DQQuery::groupBy() , having() and aggregate()
+    void groupBy();
+
+    /// Test DQQuery::exists() , first() and last()
+    void firstAndLast();
+
 private:
     DQConnection connect;
     QSqlDatabase db;